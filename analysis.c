@@ -0,0 +1,170 @@
+#include "include/analysis.h"
+
+#define TOTAL_INFINITE (-1L)
+#define TOTAL_CAP (1L << 40)    // Árvores de EXEC finitas mas enormes saturam aqui
+
+/* Per-program control flow */
+static void walk_program(const SimulationSystem* system, int prog_id, ProgramAnalysis* pa) {
+    const int* code = system->programs[prog_id];
+    int length = system->program_lengths[prog_id];
+    int visited[MAX_INSTRUCTIONS];
+    int exec_steps[MAX_INSTRUCTIONS], exec_programs[MAX_INSTRUCTIONS];
+    int execs = 0;
+    int pc = 0;
+    int step = 0;
+
+    for (int i = 0; i < MAX_INSTRUCTIONS; i++) visited[i] = -1;
+    memset(pa, 0, sizeof(ProgramAnalysis));
+    pa->loop_pc = -1;
+
+    while (1) {
+        if (pc >= length || code[pc] == 0) {
+            pa->terminates = 1;
+            break;
+        }
+        if (visited[pc] >= 0) {
+            pa->loop_pc = pc;
+            pa->loop_length = step - visited[pc];
+            pa->blocks_forever = code[pc] < 0;
+            break;
+        }
+        visited[pc] = step++;
+
+        int instruction = code[pc];
+        if (instruction < 0) {
+            // I/O: o pc não avança, o processo volta sempre a bloquear
+        } else if (instruction >= 101 && instruction <= 199) {
+            int jump = instruction - 100;
+            pc = pc - jump >= 0 ? pc - jump : 0;
+        } else {
+            if (instruction >= 201 && instruction <= 299 && instruction % 100 < 5) {
+                exec_steps[execs] = step - 1;
+                exec_programs[execs] = instruction % 100;
+                execs++;
+            }
+            pc++;
+        }
+    }
+
+    // EXECs a partir da entrada do ciclo repetem-se para sempre
+    int loop_step = pa->loop_pc >= 0 ? visited[pa->loop_pc] : step;
+    for (int i = 0; i < execs; i++) {
+        if (exec_steps[i] >= loop_step) {
+            pa->spawns_in_loop++;
+            pa->loop_spawns[exec_programs[i]]++;
+        } else {
+            pa->spawns[exec_programs[i]]++;
+        }
+    }
+}
+
+/* Spawn graph */
+static long total_from(WorkloadAnalysis* analysis, int prog_id, int* state, long* memo) {
+    if (state[prog_id] == 1) return TOTAL_INFINITE;    // Ciclo no grafo de EXEC
+    if (state[prog_id] == 2) return memo[prog_id];
+
+    const ProgramAnalysis* pa = &analysis->programs[prog_id];
+    long total = 1;
+    state[prog_id] = 1;
+
+    if (pa->spawns_in_loop > 0) {
+        total = TOTAL_INFINITE;
+    }
+    for (int q = 0; q < 5 && total != TOTAL_INFINITE; q++) {
+        if (pa->spawns[q] == 0) continue;
+
+        long child = total_from(analysis, q, state, memo);
+        if (child == TOTAL_INFINITE) total = TOTAL_INFINITE;
+        else if (child > TOTAL_CAP / pa->spawns[q] || total + child * pa->spawns[q] > TOTAL_CAP) total = TOTAL_CAP;
+        else total += child * pa->spawns[q];
+    }
+
+    state[prog_id] = 2;
+    memo[prog_id] = total;
+    return total;
+}
+
+static void mark_reachable(WorkloadAnalysis* analysis, int prog_id) {
+    ProgramAnalysis* pa = &analysis->programs[prog_id];
+    if (pa->reachable) return;
+
+    pa->reachable = 1;
+    for (int q = 0; q < 5; q++) {
+        if (pa->spawns[q] > 0 || pa->loop_spawns[q] > 0) mark_reachable(analysis, q);
+    }
+}
+
+void analyze_workload(const SimulationSystem* system, WorkloadAnalysis* analysis) {
+    memset(analysis, 0, sizeof(WorkloadAnalysis));
+    for (int p = 0; p < 5; p++) {
+        walk_program(system, p, &analysis->programs[p]);
+    }
+
+    int state[5] = {0};
+    long memo[5] = {0};
+    analysis->total_processes = total_from(analysis, 0, state, memo);
+    analysis->unbounded = analysis->total_processes == TOTAL_INFINITE;
+
+    mark_reachable(analysis, 0);
+    for (int p = 0; p < 5; p++) {
+        const ProgramAnalysis* pa = &analysis->programs[p];
+        if (pa->reachable && !pa->terminates) analysis->non_terminating = 1;
+    }
+
+    // PIDs nunca são reutilizados: nunca há mais de MAX_PROCESSES processos
+    if (analysis->unbounded || analysis->total_processes > MAX_PROCESSES) {
+        analysis->max_live = MAX_PROCESSES;
+    } else {
+        analysis->max_live = (int)analysis->total_processes;
+    }
+    analysis->max_queue_depth = analysis->max_live;
+}
+
+/* Pre-sizing */
+/**
+ * Fills the PCB and queue-node pools up to the bound, so no allocation
+ * during the run reaches the arena (or malloc).
+ */
+int presize_system(SimulationSystem* system, const WorkloadAnalysis* analysis, int external) {
+    int bound = external ? MAX_PROCESSES : analysis->max_live;
+    int live = procset_count(&system->live_set);
+    if (bound <= live) return 1;
+
+    // Cada processo vivo ocupa no máximo um nó de fila
+    return arena_pool_reserve(&system->process_pool, (size_t)(bound - live)) &&
+           arena_pool_reserve(&system->node_pool, (size_t)(bound - live));
+}
+
+/* Report */
+void print_workload_analysis(const WorkloadAnalysis* analysis, FILE* out) {
+    for (int p = 0; p < 5; p++) {
+        const ProgramAnalysis* pa = &analysis->programs[p];
+        if (!pa->reachable) continue;
+
+        fprintf(out, "program %d\t", p);
+        if (pa->terminates) fprintf(out, "terminates");
+        else if (pa->blocks_forever) fprintf(out, "repeats the I/O at pc %d forever", pa->loop_pc);
+        else fprintf(out, "loops forever at pc %d (length %d)", pa->loop_pc, pa->loop_length);
+
+        for (int q = 0; q < 5; q++) {
+            if (pa->spawns[q] > 0) fprintf(out, "\tspawns %dx program %d", pa->spawns[q], q);
+        }
+        if (pa->spawns_in_loop > 0) fprintf(out, "\tspawns inside its loop");
+        fputc('\n', out);
+    }
+
+    if (analysis->unbounded) fprintf(out, "processes\tunbounded\n");
+    else fprintf(out, "processes\t%ld\n", analysis->total_processes);
+    fprintf(out, "max live\t%d\n", analysis->max_live);
+    fprintf(out, "max queue depth\t%d\n", analysis->max_queue_depth);
+
+    if (analysis->unbounded) {
+        fprintf(out, "warning\tunbounded process creation: only the first %d PIDs are created\n", MAX_PROCESSES);
+    } else if (analysis->total_processes > MAX_PROCESSES) {
+        fprintf(out, "warning\t%ld processes exceed the %d PIDs: later EXECs are ignored\n",
+                analysis->total_processes, MAX_PROCESSES);
+    }
+    if (analysis->non_terminating) {
+        fprintf(out, "warning\tsome processes never exit: the run lasts until the tick limit\n");
+    }
+}
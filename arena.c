@@ -0,0 +1,113 @@
+#include <stdlib.h>
+#include "include/arena.h"
+
+#define ALIGN_UP(n) (((n) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+#define BLOCK_HEADER ALIGN_UP(sizeof(ArenaBlock))
+
+/* Arena */
+void arena_init(Arena *arena, size_t block_size) {
+    arena->blocks = NULL;
+    arena->block_size = block_size > 0 ? block_size : ARENA_DEFAULT_BLOCK;
+    arena->reserved = 0;
+}
+
+static ArenaBlock* add_block(Arena *arena, size_t min_size) {
+    size_t size = arena->block_size > min_size ? arena->block_size : min_size;
+    ArenaBlock *block = (ArenaBlock*)malloc(BLOCK_HEADER + size);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->size = size;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->reserved += size;
+    return block;
+}
+
+/**
+ * Makes sure the next `bytes` of allocations fit in the current block, so
+ * a run that was sized up front never calls malloc again.
+ * Returns 1 on success.
+ */
+int arena_reserve(Arena *arena, size_t bytes) {
+    ArenaBlock *block = arena->blocks;
+    if (block != NULL && block->size - block->used >= bytes) {
+        return 1;
+    }
+    return add_block(arena, bytes) != NULL;
+}
+
+/**
+ * Allocates `size` bytes (16-byte aligned, not zeroed).
+ * Returns NULL if the system is out of memory.
+ */
+void* arena_alloc(Arena *arena, size_t size) {
+    size = ALIGN_UP(size);
+
+    ArenaBlock *block = arena->blocks;
+    if (block == NULL || block->size - block->used < size) {
+        block = add_block(arena, size);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    void *object = (char*)block + BLOCK_HEADER + block->used;
+    block->used += size;
+    return object;
+}
+
+/**
+ * Frees every block of the arena at once.
+ */
+void arena_release(Arena *arena) {
+    ArenaBlock *block = arena->blocks;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+    arena->reserved = 0;
+}
+
+/* Pools */
+void arena_pool_init(ArenaPool *pool, Arena *arena, size_t object_size) {
+    pool->arena = arena;
+    pool->object_size = object_size < sizeof(void*) ? sizeof(void*) : object_size;
+    pool->free_list = NULL;
+}
+
+/**
+ * Puts `count` objects on the free list at once, in one arena block, so
+ * later allocations never reach the arena.
+ * Returns 1 on success.
+ */
+int arena_pool_reserve(ArenaPool *pool, size_t count) {
+    size_t size = ALIGN_UP(pool->object_size);
+    if (!arena_reserve(pool->arena, count * size)) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        arena_pool_free(pool, arena_alloc(pool->arena, size));
+    }
+    return 1;
+}
+
+void* arena_pool_alloc(ArenaPool *pool) {
+    if (pool->free_list != NULL) {
+        void *object = pool->free_list;
+        pool->free_list = *(void**)object;
+        return object;
+    }
+    return arena_alloc(pool->arena, pool->object_size);
+}
+
+void arena_pool_free(ArenaPool *pool, void *object) {
+    if (object == NULL) {
+        return;
+    }
+    *(void**)object = pool->free_list;
+    pool->free_list = object;
+}
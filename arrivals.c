@@ -0,0 +1,85 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/arrivals.h"
+
+/* Chunked reading */
+static void refill(ArrivalStream* stream) {
+    char line[256];
+
+    stream->count = 0;
+    stream->index = 0;
+    while (stream->count < ARRIVAL_CHUNK && !stream->eof) {
+        if (!fgets(line, sizeof(line), stream->file)) {
+            stream->eof = 1;
+            break;
+        }
+        stream->line++;
+
+        char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') cursor++;
+        if (*cursor == '#' || *cursor == '\n' || *cursor == '\r' || *cursor == '\0') continue;
+
+        char* end;
+        long time = strtol(cursor, &end, 10);
+        if (end == cursor || time < 0 || time > INT_MAX) {
+            fprintf(stderr, "arrivals: bad record at line %ld\n", stream->line);
+            continue;
+        }
+        cursor = end;
+        long program_id = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            fprintf(stderr, "arrivals: bad record at line %ld\n", stream->line);
+            continue;
+        }
+
+        if (time < stream->last_time) {
+            stream->out_of_order++;
+        } else {
+            stream->last_time = (int)time;
+        }
+        stream->chunk[stream->count].time = (int)time;
+        stream->chunk[stream->count].program_id = (int)program_id;
+        stream->count++;
+    }
+}
+
+ArrivalStream* arrivals_open(const char* path) {
+    ArrivalStream* stream = (ArrivalStream*)calloc(1, sizeof(ArrivalStream));
+    if (!stream) return NULL;
+
+    stream->file = fopen(path, "r");
+    if (!stream->file) {
+        free(stream);
+        return NULL;
+    }
+    refill(stream);
+    return stream;
+}
+
+void arrivals_close(ArrivalStream* stream) {
+    if (!stream) return;
+
+    fclose(stream->file);
+    free(stream);
+}
+
+/* Queries */
+int arrivals_next_time(ArrivalStream* stream) {
+    if (!stream) return -1;
+
+    if (stream->index >= stream->count) {
+        if (stream->eof) return -1;
+        refill(stream);
+        if (stream->count == 0) return -1;
+    }
+    return stream->chunk[stream->index].time;
+}
+
+int arrivals_pop_due(ArrivalStream* stream, int time, Arrival* arrival) {
+    int next = arrivals_next_time(stream);
+    if (next < 0 || next > time) return 0;
+
+    *arrival = stream->chunk[stream->index++];
+    return 1;
+}
@@ -0,0 +1,357 @@
+#define _GNU_SOURCE     // fopencookie
+#include <string.h>
+#include "include/async_writer.h"
+#include "include/timer.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define ASYNC_WRITER_IO_URING
+#endif
+#endif
+
+#define STDIO_BUFFER (64 * 1024)
+
+#ifdef ASYNC_WRITER_IO_URING
+// Anel de uma só entrada: a thread tem no máximo uma escrita em curso
+typedef struct {
+    int fd;
+    atomic_uint* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    atomic_uint* cq_head;
+    atomic_uint* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_sqe* sqes;
+    struct io_uring_cqe* cqes;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} Uring;
+#endif
+
+typedef struct {
+    int fd;
+    char* buffers[2];
+    size_t size;                // Capacidade de cada buffer
+    int active;                 // Buffer que a simulação está a encher
+    size_t filled;
+    // Partilhado com a thread (protegido por lock)
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    int pending;                // Buffer entregue à thread (-1 = nenhum)
+    size_t pending_size;
+    int quit;
+    int failed;
+    off_t offset;               // Posição da próxima escrita (só a thread)
+    pthread_t thread;
+#ifdef ASYNC_WRITER_IO_URING
+    Uring ring;
+    int use_ring;
+#endif
+    AsyncWriterStats local;
+    AsyncWriterStats* stats;
+} AsyncWriter;
+
+/* io_uring (raw system calls, no liburing) */
+#ifdef ASYNC_WRITER_IO_URING
+static int uring_setup(Uring* ring) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(Uring));
+
+    ring->fd = (int)syscall(__NR_io_uring_setup, 1, &params);
+    if (ring->fd < 0) return 0;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single) {
+        if (ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single ? ring->sq_ring
+                           : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                                            MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+        if (ring->cq_ring != MAP_FAILED && !single) munmap(ring->cq_ring, ring->cq_ring_size);
+        if (ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+        close(ring->fd);
+        return 0;
+    }
+
+    char* sq = (char*)ring->sq_ring;
+    char* cq = (char*)ring->cq_ring;
+    ring->sq_tail = (atomic_uint*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (atomic_uint*)(cq + params.cq_off.head);
+    ring->cq_tail = (atomic_uint*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    return 1;
+}
+
+static void uring_teardown(Uring* ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+// Submits one write and waits for it; returns the bytes written or -errno
+static long uring_write(Uring* ring, int fd, const char* data, size_t size, off_t offset) {
+    unsigned tail = atomic_load_explicit(ring->sq_tail, memory_order_relaxed);
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)data;
+    sqe->len = (uint32_t)size;
+    sqe->off = (uint64_t)offset;
+    ring->sq_array[index] = index;
+    atomic_store_explicit(ring->sq_tail, tail + 1, memory_order_release);
+
+    long submitted = syscall(__NR_io_uring_enter, ring->fd, 1, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+    if (submitted <= 0) {
+        // Nada foi submetido (interrompido, sem recursos...): retira a entrada
+        long error = submitted < 0 ? errno : EAGAIN;
+        atomic_store_explicit(ring->sq_tail, tail, memory_order_release);
+        return -error;
+    }
+
+    // A espera pode acabar sem completion (sinal): a escrita continua em curso
+    unsigned head = atomic_load_explicit(ring->cq_head, memory_order_relaxed);
+    while (head == atomic_load_explicit(ring->cq_tail, memory_order_acquire)) {
+        if (syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+            errno != EINTR && errno != EAGAIN) {
+            return -errno;
+        }
+    }
+    long result = ring->cqes[head & *ring->cq_mask].res;
+    atomic_store_explicit(ring->cq_head, head + 1, memory_order_release);
+    return result;
+}
+#endif
+
+/* Writer thread */
+static int write_all(AsyncWriter* writer, const char* data, size_t size) {
+    while (size > 0) {
+        long written;
+#ifdef ASYNC_WRITER_IO_URING
+        if (writer->use_ring) {
+            written = uring_write(&writer->ring, writer->fd, data, size, writer->offset);
+            // Kernel sem IORING_OP_WRITE (ou sem permissão): pwrite daqui em diante
+            if (written == -EINVAL || written == -EOPNOTSUPP || written == -EPERM || written == -ENOSYS) {
+                uring_teardown(&writer->ring);
+                writer->use_ring = 0;
+                writer->local.backend = "pwrite";
+                continue;
+            }
+            if (written == -EINTR || written == -EAGAIN) continue;
+        } else
+#endif
+        {
+            written = pwrite(writer->fd, data, size, writer->offset);
+            if (written < 0 && errno == EINTR) continue;
+        }
+        if (written <= 0) return 0;
+
+        data += written;
+        size -= (size_t)written;
+        writer->offset += written;
+    }
+    return 1;
+}
+
+static void* writer_thread(void* arg) {
+    AsyncWriter* writer = (AsyncWriter*)arg;
+
+    pthread_mutex_lock(&writer->lock);
+    while (1) {
+        while (writer->pending < 0 && !writer->quit) {
+            pthread_cond_wait(&writer->changed, &writer->lock);
+        }
+        if (writer->pending < 0) break;    // quit sem nada pendente
+
+        int buffer = writer->pending;
+        size_t size = writer->pending_size;
+        pthread_mutex_unlock(&writer->lock);
+
+        int ok = write_all(writer, writer->buffers[buffer], size);
+
+        pthread_mutex_lock(&writer->lock);
+        if (!ok) writer->failed = 1;
+        writer->local.bytes += size;
+        writer->local.buffers++;
+        writer->pending = -1;
+        pthread_cond_broadcast(&writer->changed);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+/**
+ * Hands the active buffer to the thread and switches to the other one,
+ * first waiting (and counting the stall) if the thread is still busy.
+ */
+static int hand_off(AsyncWriter* writer, int closing) {
+    pthread_mutex_lock(&writer->lock);
+    if (writer->pending >= 0) {
+        uint64_t start = timer_now_ns();
+        while (writer->pending >= 0) {
+            pthread_cond_wait(&writer->changed, &writer->lock);
+        }
+        // A espera do fecho não é pressão do disco
+        if (!closing) {
+            writer->local.stalls++;
+            writer->local.stall_ns += timer_now_ns() - start;
+        }
+    }
+    int failed = writer->failed;
+    if (writer->filled > 0) {
+        writer->pending = writer->active;
+        writer->pending_size = writer->filled;
+        pthread_cond_broadcast(&writer->changed);
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    writer->active = 1 - writer->active;
+    writer->filled = 0;
+    return !failed;
+}
+
+/* Stream callbacks */
+static ssize_t cookie_write(void* cookie, const char* data, size_t size) {
+    AsyncWriter* writer = (AsyncWriter*)cookie;
+    size_t done = 0;
+
+    while (done < size) {
+        if (writer->filled == writer->size && !hand_off(writer, 0)) {
+            errno = EIO;
+            return done > 0 ? (ssize_t)done : -1;
+        }
+        size_t chunk = size - done;
+        if (chunk > writer->size - writer->filled) chunk = writer->size - writer->filled;
+        memcpy(writer->buffers[writer->active] + writer->filled, data + done, chunk);
+        writer->filled += chunk;
+        done += chunk;
+    }
+    return (ssize_t)size;
+}
+
+static int cookie_close(void* cookie) {
+    AsyncWriter* writer = (AsyncWriter*)cookie;
+
+    hand_off(writer, 1);
+    pthread_mutex_lock(&writer->lock);
+    writer->quit = 1;
+    pthread_cond_broadcast(&writer->changed);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    int failed = writer->failed || close(writer->fd) != 0;
+#ifdef ASYNC_WRITER_IO_URING
+    if (writer->use_ring) uring_teardown(&writer->ring);
+#endif
+    writer->local.failed = failed;
+    if (writer->stats) *writer->stats = writer->local;
+
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->changed);
+    free(writer->buffers[0]);
+    free(writer->buffers[1]);
+    free(writer);
+    return failed ? EOF : 0;
+}
+
+/* Lifecycle */
+FILE* async_writer_open(const char* path, size_t buffer_size, AsyncWriterStats* stats) {
+    AsyncWriter* writer = (AsyncWriter*)calloc(1, sizeof(AsyncWriter));
+    if (!writer) return NULL;
+
+    writer->size = buffer_size > 0 ? buffer_size : ASYNC_WRITER_DEFAULT_BUFFER;
+    writer->buffers[0] = (char*)malloc(writer->size);
+    writer->buffers[1] = (char*)malloc(writer->size);
+    writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    writer->pending = -1;
+    writer->stats = stats;
+    writer->local.backend = "pwrite";
+    if (!writer->buffers[0] || !writer->buffers[1] || writer->fd < 0) {
+        if (writer->fd >= 0) close(writer->fd);
+        free(writer->buffers[0]);
+        free(writer->buffers[1]);
+        free(writer);
+        return NULL;
+    }
+#ifdef ASYNC_WRITER_IO_URING
+    writer->use_ring = uring_setup(&writer->ring);
+    if (writer->use_ring) writer->local.backend = "io_uring";
+#endif
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->changed, NULL);
+    cookie_io_functions_t functions = {NULL, cookie_write, NULL, cookie_close};
+    FILE* file = NULL;
+    if (pthread_create(&writer->thread, NULL, writer_thread, writer) == 0) {
+        file = fopencookie(writer, "w", functions);
+        if (!file) {
+            pthread_mutex_lock(&writer->lock);
+            writer->quit = 1;
+            pthread_cond_broadcast(&writer->changed);
+            pthread_mutex_unlock(&writer->lock);
+            pthread_join(writer->thread, NULL);
+        }
+    }
+    if (!file) {
+#ifdef ASYNC_WRITER_IO_URING
+        if (writer->use_ring) uring_teardown(&writer->ring);
+#endif
+        pthread_mutex_destroy(&writer->lock);
+        pthread_cond_destroy(&writer->changed);
+        close(writer->fd);
+        free(writer->buffers[0]);
+        free(writer->buffers[1]);
+        free(writer);
+        return NULL;
+    }
+
+    // O buffer do stdio só junta as escritas pequenas antes da cópia
+    setvbuf(file, NULL, _IOFBF, STDIO_BUFFER);
+    return file;
+}
+
+#else
+
+FILE* async_writer_open(const char* path, size_t buffer_size, AsyncWriterStats* stats) {
+    (void)buffer_size;
+    if (stats) {
+        memset(stats, 0, sizeof(AsyncWriterStats));
+        stats->backend = "stdio";
+    }
+    return fopen(path, "w");
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,106 @@
+#include "include/burst.h"
+#include "include/sink.h"
+
+/* Burst executor */
+int burst_length(const PCB* proc, int budget, int exec_spawns, int* pc) {
+    int visited[MAX_INSTRUCTIONS];  // Tick em que cada pc foi executado (-1 = ainda não)
+    int position = proc->pc;
+    int ticks = 0;
+
+    for (int i = 0; i < MAX_INSTRUCTIONS; i++) visited[i] = -1;
+
+    while (ticks < budget) {
+        if (position < 0 || position >= proc->instruction_count) break;
+
+        int instruction = proc->instructions[position];
+        if (instruction <= 0) break;    // Fim ou I/O
+        if (instruction >= 201 && instruction <= 299 && exec_spawns && instruction % 100 < 5) break;
+
+        if (visited[position] >= 0) {
+            // Ciclo só de computação: voltas inteiras de uma vez
+            int length = ticks - visited[position];
+            ticks += (budget - ticks) / length * length;
+            for (int i = 0; i < MAX_INSTRUCTIONS; i++) visited[i] = -1;
+            if (ticks >= budget) break;
+        }
+        visited[position] = ticks;
+
+        if (instruction >= 101 && instruction <= 199) {
+            int jump = instruction - 100;
+            position = position - jump >= 0 ? position - jump : 0;
+        } else {
+            position++;
+        }
+        ticks++;
+    }
+
+    *pc = position;
+    return ticks;
+}
+
+/* Skip-ahead engine */
+int simulation_skip_ahead(SimulationSystem* system) {
+    int now = system->current_time;
+    int table = system->sink_count == 1 && system->sinks[0] == &table_output_sink;
+
+    if (!(table || system->sink_count == 0) || !procset_is_empty(&system->dirty_set) ||
+        system->state_counts[NEW] > 0 || system->state_counts[EXIT] > 0 || !has_live_processes(system)) {
+        return 0;
+    }
+
+    // Até ao próximo evento externo ao processo em execução
+    int limit = system->max_ticks - now;
+    int completion = io_next_completion(&system->io);
+    if (completion >= 0 && completion - now - 1 < limit) limit = completion - now - 1;
+    int arrival = arrivals_next_time(system->arrivals);
+    if (arrival >= 0 && arrival - now - 1 < limit) limit = arrival - now - 1;
+
+    PCB* proc = system->running_process;
+    int ticks = limit;
+    int pc = 0;
+    int renewals = 0;
+    int last_renewal = now;
+
+    if (proc) {
+        int remaining = proc->remaining_quantum;
+        // Com outros prontos, o fim do quantum entrega o CPU: pára antes
+        if (system->state_counts[READY] > 0 && remaining - 1 < ticks) ticks = remaining - 1;
+        if (ticks < 2) return 0;
+
+        ticks = burst_length(proc, ticks, system->next_pid <= MAX_PROCESSES, &pc);
+        if (ticks >= remaining) {
+            renewals = 1 + (ticks - remaining) / QUANTUM;
+            last_renewal = now + remaining + (renewals - 1) * QUANTUM;
+        }
+    } else if (system->state_counts[READY] > 0) {
+        return 0;
+    }
+    if (ticks < 2) return 0;   // Um só tick: o passo normal chega
+
+    // As linhas repetem-se: nada mudou de estado
+    if (table) {
+        FILE* out = system->output ? system->output : stdout;
+        for (int i = 1; i <= ticks; i++) {
+            print_state_row(out, now + i, system->row_cells);
+        }
+    }
+
+    if (proc) {
+        proc->pc = pc;
+        if (renewals > 0) {
+            // Cada fim de quantum sem concorrência: RUNNING -> READY -> RUNNING no mesmo tick
+            ProcessMetrics* pm = &system->metrics.processes[proc->pid - 1];
+            pm->ticks_in_state[RUNNING] += last_renewal - pm->state_since;
+            pm->state_since = last_renewal;
+            pm->dispatches += renewals;
+            system->metrics.context_switches += renewals;
+            proc->remaining_quantum = QUANTUM - (now + ticks - last_renewal);
+        } else {
+            proc->remaining_quantum -= ticks;
+        }
+        system->metrics.busy_ticks += ticks;
+    }
+    system->metrics.ticks += ticks;
+    system->current_time += ticks;
+    return ticks;
+}
@@ -0,0 +1,438 @@
+#include <stdint.h>
+#include "include/checkpoint.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+/* Buffer helpers */
+static int put_bytes(CheckpointBuffer* buffer, const void* bytes, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+        while (capacity < buffer->size + size) capacity *= 2;
+
+        unsigned char* data = (unsigned char*)realloc(buffer->data, capacity);
+        if (!data) return 0;
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, bytes, size);
+    buffer->size += size;
+    return 1;
+}
+
+static int put_int(CheckpointBuffer* buffer, int value) {
+    int32_t v = (int32_t)value;
+    return put_bytes(buffer, &v, sizeof(v));
+}
+
+static int put_long(CheckpointBuffer* buffer, long value) {
+    int64_t v = (int64_t)value;
+    return put_bytes(buffer, &v, sizeof(v));
+}
+
+static int put_queue(CheckpointBuffer* buffer, Queue* queue) {
+    int ok = put_int(buffer, queue ? (int)queueSize(queue) : 0);
+    for (QueueNode* node = queue ? queue->front : NULL; node && ok; node = node->next) {
+        ok = put_int(buffer, ((PCB*)node->data)->pid);
+    }
+    return ok;
+}
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+    int ok;
+} Reader;
+
+static void get_bytes(Reader* reader, void* bytes, size_t size) {
+    if (!reader->ok || reader->offset + size > reader->size) {
+        reader->ok = 0;
+        memset(bytes, 0, size);
+        return;
+    }
+    memcpy(bytes, reader->data + reader->offset, size);
+    reader->offset += size;
+}
+
+static int get_int(Reader* reader) {
+    int32_t v;
+    get_bytes(reader, &v, sizeof(v));
+    return (int)v;
+}
+
+static long get_long(Reader* reader) {
+    int64_t v;
+    get_bytes(reader, &v, sizeof(v));
+    return (long)v;
+}
+
+static PCB* get_process(Reader* reader, SimulationSystem* system) {
+    int pid = get_int(reader);
+    if (pid < 1 || pid > MAX_PROCESSES || !system->processes[pid - 1]) {
+        reader->ok = 0;
+        return NULL;
+    }
+    return system->processes[pid - 1];
+}
+
+static void get_queue(Reader* reader, SimulationSystem* system, Queue* queue) {
+    int count = get_int(reader);
+    if (count < 0 || count > MAX_PROCESSES) {
+        reader->ok = 0;
+        return;
+    }
+    for (int i = 0; i < count && reader->ok; i++) {
+        PCB* proc = get_process(reader, system);
+        if (proc) enqueue(queue, proc);
+    }
+}
+
+void checkpoint_buffer_free(CheckpointBuffer* buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+/* Save */
+int checkpoint_save(const SimulationSystem* system, CheckpointBuffer* buffer) {
+    int ok = put_int(buffer, (int)CHECKPOINT_MAGIC) &&
+             put_int(buffer, CHECKPOINT_VERSION) &&
+             put_int(buffer, MAX_PROCESSES) &&
+             put_int(buffer, MAX_DEVICES) &&
+             put_int(buffer, system->current_time) &&
+             put_int(buffer, system->max_ticks) &&
+             put_int(buffer, system->next_pid) &&
+             put_int(buffer, system->rejected_injections) &&
+             put_bytes(buffer, system->programs, sizeof(system->programs)) &&
+             put_bytes(buffer, system->program_counts, sizeof(system->program_counts)) &&
+             put_bytes(buffer, system->program_lengths, sizeof(system->program_lengths));
+
+    // Processes
+    ok = ok && put_int(buffer, system->state_counts[NEW] + system->state_counts[READY] +
+                               system->state_counts[RUNNING] + system->state_counts[BLOCKED] +
+                               system->state_counts[EXIT]);
+    for (int slot = procset_next(&system->live_set, 0); slot >= 0 && ok;
+         slot = procset_next(&system->live_set, slot + 1)) {
+        const PCB* proc = system->processes[slot];
+        ok = put_int(buffer, proc->pid) &&
+             put_int(buffer, proc->program_id) &&
+             put_int(buffer, proc->pc) &&
+             put_int(buffer, proc->state) &&
+             put_int(buffer, proc->remaining_quantum) &&
+             put_int(buffer, proc->blocked_until) &&
+             put_int(buffer, proc->time_in_state) &&
+             put_int(buffer, proc->io_device) &&
+             put_int(buffer, proc->io_service) &&
+             put_int(buffer, proc->instruction_count) &&
+             put_bytes(buffer, proc->instructions, proc->instruction_count * sizeof(int));
+    }
+
+    // Queue orderings
+    ok = ok && put_int(buffer, system->running_process ? system->running_process->pid : 0) &&
+         put_queue(buffer, system->new_queue) &&
+         put_queue(buffer, system->ready_queue) &&
+         put_queue(buffer, system->exit_queue);
+
+    // Devices
+    for (int d = 0; d < MAX_DEVICES && ok; d++) {
+        const IoDevice* device = &system->io.devices[d];
+        ok = put_int(buffer, device->configured) &&
+             put_int(buffer, device->channels) &&
+             put_int(buffer, device->busy) &&
+             put_long(buffer, device->requests) &&
+             put_long(buffer, device->queued) &&
+             put_long(buffer, device->completed) &&
+             put_queue(buffer, device->wait_queue);
+    }
+    ok = ok && put_int(buffer, system->io.heap_size) && put_long(buffer, system->io.next_seq);
+    for (int i = 0; i < system->io.heap_size && ok; i++) {
+        const IoCompletion* entry = &system->io.heap[i];
+        ok = put_int(buffer, entry->time) &&
+             put_int(buffer, entry->device) &&
+             put_long(buffer, entry->seq) &&
+             put_int(buffer, ((PCB*)entry->data)->pid);
+    }
+
+    // Metrics (only plain counters)
+    ok = ok && put_int(buffer, (int)sizeof(SimulationMetrics)) &&
+         put_bytes(buffer, &system->metrics, sizeof(SimulationMetrics));
+    return ok;
+}
+
+/* Restore */
+int checkpoint_restore(SimulationSystem* system, const unsigned char* data, size_t size) {
+    Reader reader = {data, size, 0, 1};
+
+    if ((uint32_t)get_int(&reader) != CHECKPOINT_MAGIC || get_int(&reader) != CHECKPOINT_VERSION ||
+        get_int(&reader) != MAX_PROCESSES || get_int(&reader) != MAX_DEVICES) {
+        return 0;
+    }
+
+    initialize_system(system);
+    system->current_time = get_int(&reader);
+    system->max_ticks = get_int(&reader);
+    system->next_pid = get_int(&reader);
+    system->rejected_injections = get_int(&reader);
+    get_bytes(&reader, system->programs, sizeof(system->programs));
+    get_bytes(&reader, system->program_counts, sizeof(system->program_counts));
+    get_bytes(&reader, system->program_lengths, sizeof(system->program_lengths));
+
+    // Processes
+    int count = get_int(&reader);
+    if (count < 0 || count > MAX_PROCESSES) reader.ok = 0;
+    for (int i = 0; i < count && reader.ok; i++) {
+        PCB* proc = allocate_process(system);
+        if (!proc) {
+            reader.ok = 0;
+            break;
+        }
+        proc->pid = get_int(&reader);
+        proc->program_id = get_int(&reader);
+        proc->pc = get_int(&reader);
+        proc->state = get_int(&reader);
+        proc->remaining_quantum = get_int(&reader);
+        proc->blocked_until = get_int(&reader);
+        proc->time_in_state = get_int(&reader);
+        proc->io_device = get_int(&reader);
+        proc->io_service = get_int(&reader);
+        proc->instruction_count = get_int(&reader);
+
+        if (proc->pid < 1 || proc->pid > MAX_PROCESSES || system->processes[proc->pid - 1] ||
+            proc->state < 0 || proc->state >= NUM_STATES ||
+            proc->instruction_count < 0 || proc->instruction_count > MAX_INSTRUCTIONS) {
+            reader.ok = 0;
+            break;
+        }
+        get_bytes(&reader, proc->instructions, proc->instruction_count * sizeof(int));
+        index_process(system, proc);
+    }
+
+    // Queue orderings
+    int running = get_int(&reader);
+    if (running != 0) {
+        if (running < 1 || running > MAX_PROCESSES || !system->processes[running - 1]) reader.ok = 0;
+        else system->running_process = system->processes[running - 1];
+    }
+    get_queue(&reader, system, system->new_queue);
+    get_queue(&reader, system, system->ready_queue);
+    get_queue(&reader, system, system->exit_queue);
+
+    // Devices
+    for (int d = 0; d < MAX_DEVICES && reader.ok; d++) {
+        IoDevice* device = &system->io.devices[d];
+        int configured = get_int(&reader);
+        int channels = get_int(&reader);
+        if (configured) io_configure_device(&system->io, d, channels);
+        device->busy = get_int(&reader);
+        device->requests = get_long(&reader);
+        device->queued = get_long(&reader);
+        device->completed = get_long(&reader);
+        if (configured) {
+            get_queue(&reader, system, device->wait_queue);
+        } else if (get_int(&reader) != 0) {
+            reader.ok = 0;
+        }
+    }
+    int heap_size = get_int(&reader);
+    system->io.next_seq = get_long(&reader);
+    if (heap_size < 0 || heap_size > MAX_PROCESSES) reader.ok = 0;
+    for (int i = 0; i < heap_size && reader.ok; i++) {
+        IoCompletion* entry = &system->io.heap[i];
+        entry->time = get_int(&reader);
+        entry->device = get_int(&reader);
+        entry->seq = get_long(&reader);
+        entry->data = get_process(&reader, system);
+        if (entry->device < 0 || entry->device >= MAX_DEVICES) reader.ok = 0;
+    }
+    if (reader.ok) system->io.heap_size = heap_size;
+
+    // Metrics
+    if (get_int(&reader) != (int)sizeof(SimulationMetrics)) reader.ok = 0;
+    get_bytes(&reader, &system->metrics, sizeof(SimulationMetrics));
+
+    if (!reader.ok) {
+        cleanup_simulation(system);
+        return 0;
+    }
+    return 1;
+}
+
+/* Files */
+int checkpoint_write_file(const SimulationSystem* system, const char* path) {
+    CheckpointBuffer buffer = {NULL, 0, 0};
+    int ok = checkpoint_save(system, &buffer);
+
+    if (ok) {
+        FILE* file = fopen(path, "wb");
+        ok = file && fwrite(buffer.data, 1, buffer.size, file) == buffer.size;
+        if (file && fclose(file) != 0) ok = 0;
+    }
+    checkpoint_buffer_free(&buffer);
+    return ok;
+}
+
+int checkpoint_read_file(SimulationSystem* system, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+
+    CheckpointBuffer buffer = {NULL, 0, 0};
+    unsigned char chunk[4096];
+    size_t n;
+    int ok = 1;
+    while (ok && (n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        ok = put_bytes(&buffer, chunk, n);
+    }
+    fclose(file);
+
+    ok = ok && checkpoint_restore(system, buffer.data, buffer.size);
+    checkpoint_buffer_free(&buffer);
+    return ok;
+}
+
+/* Fork */
+/**
+ * Branches src into dst. dst gets its own arena and queues and writes its
+ * table to src's output stream; it shares no other mutable state with src.
+ */
+int simulation_fork(const SimulationSystem* src, SimulationSystem* dst) {
+    CheckpointBuffer buffer = {NULL, 0, 0};
+    int ok = checkpoint_save(src, &buffer) && checkpoint_restore(dst, buffer.data, buffer.size);
+
+    checkpoint_buffer_free(&buffer);
+    if (ok) {
+        dst->output = src->output;
+    }
+    return ok;
+}
+
+/**
+ * Branches the whole program with fork(): the child continues from the
+ * same state with copy-on-write memory (programs, PCBs and queues are only
+ * copied when one side writes them). Output buffers are flushed first so
+ * nothing is written twice.
+ */
+int simulation_fork_process(SimulationSystem* system) {
+#ifndef _WIN32
+    if (system && system->output) fflush(system->output);
+    fflush(NULL);
+    return (int)fork();
+#else
+    (void)system;
+    return -1;
+#endif
+}
+
+/* Checkpoint paths */
+/**
+ * Parses path_pattern: literal text, "%%" and exactly one "%d" or "%0Nd"
+ * (N = 1..9) for the tick. Returns the width (0 for "%d"), or -1 if the
+ * pattern has any other conversion or not exactly one tick conversion.
+ */
+static int parse_pattern(const char* pattern, const char** conversion, const char** after) {
+    int width = -1;
+
+    for (const char* p = pattern; *p; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+        if (width >= 0) return -1;     // Mais do que uma conversão
+
+        const char* start = p++;
+        int digits = 0;
+        if (*p == '0') {
+            p++;
+            if (*p < '1' || *p > '9') return -1;
+            digits = *p++ - '0';
+        }
+        if (*p != 'd') return -1;
+        width = digits;
+        *conversion = start;
+        *after = p + 1;
+    }
+    return width;
+}
+
+int checkpoint_pattern_valid(const char* path_pattern) {
+    const char* conversion;
+    const char* after;
+    return path_pattern && parse_pattern(path_pattern, &conversion, &after) >= 0;
+}
+
+// Copies literal text, turning "%%" into '%'; returns the new length or -1 if it does not fit
+static int copy_literal(char* path, size_t size, size_t length, const char* from, const char* to) {
+    for (const char* p = from; p < to; p++) {
+        if (*p == '%') p++;    // "%%"
+        if (length + 1 >= size) return -1;
+        path[length++] = *p;
+    }
+    path[length] = '\0';
+    return (int)length;
+}
+
+int checkpoint_path(char* path, size_t size, const char* path_pattern, int tick) {
+    const char* conversion;
+    const char* after;
+    int width = path_pattern ? parse_pattern(path_pattern, &conversion, &after) : -1;
+    if (width < 0 || size == 0) return 0;
+
+    // Nunca usa o padrão (vindo da linha de comando) como formato do printf
+    char number[32];
+    snprintf(number, sizeof(number), "%0*d", width, tick);
+
+    int length = copy_literal(path, size, 0, path_pattern, conversion);
+    if (length < 0 || (size_t)length + strlen(number) >= size) return 0;
+    strcpy(path + length, number);
+    length += (int)strlen(number);
+    return copy_literal(path, size, (size_t)length, after, after + strlen(after)) >= 0;
+}
+
+/* Periodic checkpoint sink */
+typedef struct {
+    int every;
+    char pattern[256];
+} CheckpointSink;
+
+static void checkpoint_sink_tick(OutputSink* sink, SimulationSystem* system) {
+    CheckpointSink* ctx = (CheckpointSink*)sink->ctx;
+    if (system->current_time % ctx->every != 0) return;
+
+    char path[512];
+    if (!checkpoint_path(path, sizeof(path), ctx->pattern, system->current_time)) {
+        fprintf(stderr, "Checkpoint name too long: %s (tick %d)\n", ctx->pattern, system->current_time);
+    } else if (!checkpoint_write_file(system, path)) {
+        fprintf(stderr, "Error writing checkpoint %s\n", path);
+    }
+}
+
+OutputSink* checkpoint_sink_open(int every, const char* path_pattern) {
+    if (every <= 0 || !checkpoint_pattern_valid(path_pattern) ||
+        strlen(path_pattern) >= sizeof(((CheckpointSink*)0)->pattern)) {
+        return NULL;
+    }
+
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    CheckpointSink* ctx = (CheckpointSink*)calloc(1, sizeof(CheckpointSink));
+    if (!sink || !ctx) {
+        free(sink);
+        free(ctx);
+        return NULL;
+    }
+    ctx->every = every;
+    strcpy(ctx->pattern, path_pattern);
+
+    sink->on_tick = checkpoint_sink_tick;
+    sink->ctx = ctx;
+    return sink;
+}
+
+void checkpoint_sink_close(OutputSink* sink) {
+    if (!sink) return;
+
+    free(sink->ctx);
+    free(sink);
+}
@@ -0,0 +1,127 @@
+#include "include/chrome_trace.h"
+
+#define CHROME_TRACE_BUFFER (1 << 20)
+#define TRACK_PROCESSES 1
+#define TRACK_CPU 2
+
+static const char* const slice_names[NUM_STATES] = {"NEW", "READY", "RUN", "BLOCKED", "EXIT"};
+
+typedef struct {
+    FILE* file;
+    char* buffer;
+    int events;                         // Nº de eventos já escritos (para as vírgulas)
+    int span_start[MAX_PROCESSES];      // Início do estado atual de cada slot
+    int finished;
+} ChromeTrace;
+
+/* Writers */
+static void begin_event(ChromeTrace* trace) {
+    fputs(trace->events++ ? ",\n" : "\n", trace->file);
+}
+
+static void write_metadata(ChromeTrace* trace, const char* kind, int pid, int tid, const char* name, int id) {
+    begin_event(trace);
+    fprintf(trace->file, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s",
+            kind, pid, tid, name);
+    if (id >= 0) fprintf(trace->file, " %d", id);
+    fputs("\"}}", trace->file);
+}
+
+static void write_slice(ChromeTrace* trace, int track, int tid, const char* name, int id, int start, int end) {
+    if (end <= start) return;
+
+    begin_event(trace);
+    fprintf(trace->file, "{\"name\":\"%s", name);
+    if (id >= 0) fprintf(trace->file, " %d", id);
+    fprintf(trace->file, "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+            track, tid,
+            (long long)start * CHROME_TRACE_TICK_US,
+            (long long)(end - start) * CHROME_TRACE_TICK_US);
+}
+
+static void close_span(ChromeTrace* trace, const PCB* process, int state, int end) {
+    int slot = process->pid - 1;
+    int start = trace->span_start[slot];
+
+    write_slice(trace, TRACK_PROCESSES, process->pid, slice_names[state], -1, start, end);
+    if (state == RUNNING) {
+        write_slice(trace, TRACK_CPU, 0, "proc", process->pid, start, end);
+    }
+}
+
+/* Sink callbacks */
+static void chrome_trace_transition(OutputSink* sink, const SimulationSystem* system,
+                                    const PCB* process, int from, int to) {
+    ChromeTrace* trace = (ChromeTrace*)sink->ctx;
+    int slot = process->pid - 1;
+    (void)to;
+    if (trace->finished || slot < 0 || slot >= MAX_PROCESSES) return;
+
+    if (from == NO_STATE) {
+        write_metadata(trace, "thread_name", TRACK_PROCESSES, process->pid, "proc", process->pid);
+    } else {
+        close_span(trace, process, from, system->current_time);
+    }
+    trace->span_start[slot] = system->current_time;
+}
+
+static void chrome_trace_finish(OutputSink* sink, SimulationSystem* system) {
+    ChromeTrace* trace = (ChromeTrace*)sink->ctx;
+    if (trace->finished) return;
+
+    // A linha do instante t cobre [t, t+1): fecha o que ainda está aberto
+    for (int slot = procset_next(&system->live_set, 0); slot >= 0;
+         slot = procset_next(&system->live_set, slot + 1)) {
+        PCB* proc = system->processes[slot];
+        close_span(trace, proc, proc->state, system->current_time + 1);
+    }
+
+    fputs("\n]}\n", trace->file);
+    fflush(trace->file);
+    trace->finished = 1;
+}
+
+/* Lifecycle */
+OutputSink* chrome_trace_open(const char* path) {
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    ChromeTrace* trace = (ChromeTrace*)calloc(1, sizeof(ChromeTrace));
+    if (!sink || !trace) {
+        free(sink);
+        free(trace);
+        return NULL;
+    }
+
+    trace->file = fopen(path, "w");
+    if (!trace->file) {
+        free(sink);
+        free(trace);
+        return NULL;
+    }
+    trace->buffer = (char*)malloc(CHROME_TRACE_BUFFER);
+    if (trace->buffer) {
+        setvbuf(trace->file, trace->buffer, _IOFBF, CHROME_TRACE_BUFFER);
+    }
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", trace->file);
+    write_metadata(trace, "process_name", TRACK_PROCESSES, 0, "Processes", -1);
+    write_metadata(trace, "process_name", TRACK_CPU, 0, "CPU", -1);
+    write_metadata(trace, "thread_name", TRACK_CPU, 0, "cpu", 0);
+
+    sink->on_transition = chrome_trace_transition;
+    sink->on_finish = chrome_trace_finish;
+    sink->ctx = trace;
+    return sink;
+}
+
+void chrome_trace_close(OutputSink* sink) {
+    if (!sink) return;
+
+    ChromeTrace* trace = (ChromeTrace*)sink->ctx;
+    if (trace) {
+        if (!trace->finished) fputs("\n]}\n", trace->file);
+        fclose(trace->file);
+        free(trace->buffer);
+        free(trace);
+    }
+    free(sink);
+}
@@ -0,0 +1,428 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "include/columnar.h"
+
+#define TRAILER_SIZE (8 + 2 * 4)
+#define GROUP_HEADER_SIZE (4 * 4)
+#define DIRECTORY_ENTRY_SIZE (3 * 4)
+#define MAX_CODES 32
+#define MAX_CODE_NAME 16
+
+typedef struct {
+    unsigned char* data;    // Runs do row group atual
+    size_t size;
+    size_t capacity;
+    int active;             // Tem coluna no row group atual
+    int code;               // Código da run aberta
+    int run_start;          // Linha (no row group) em que a run abriu
+    int pending;            // Código no fim do tick corrente
+} Column;
+
+typedef struct {
+    long offset;
+    int first_time;
+    int rows;
+} RowGroup;
+
+typedef struct {
+    FILE* file;
+    Column columns[MAX_PROCESSES];
+    int dirty[MAX_PROCESSES];           // Colunas com transições neste tick
+    int dirty_count;
+    unsigned char is_dirty[MAX_PROCESSES];
+    int group_start;
+    int rows;               // Linhas do row group atual
+    RowGroup* groups;
+    int group_count;
+    int group_capacity;
+    int failed;
+    int finished;
+} ColumnarWriter;
+
+struct ColumnarReader {
+    FILE* file;
+    RowGroup* groups;
+    int group_count;
+    int first_time;
+    long rows;
+    int dictionary_size;
+    char names[MAX_CODES][MAX_CODE_NAME];
+};
+
+/* Encoding */
+static void write_int(ColumnarWriter* writer, int value) {
+    int32_t v = (int32_t)value;
+    if (fwrite(&v, sizeof(v), 1, writer->file) != 1) writer->failed = 1;
+}
+
+static void write_long(ColumnarWriter* writer, long value) {
+    int64_t v = (int64_t)value;
+    if (fwrite(&v, sizeof(v), 1, writer->file) != 1) writer->failed = 1;
+}
+
+static int read_int(FILE* file, int* value) {
+    int32_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+static int read_long(FILE* file, long* value) {
+    int64_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (long)v;
+    return 1;
+}
+
+static void append_run(ColumnarWriter* writer, Column* column, int code, int length) {
+    if (length <= 0) return;
+
+    if (column->size + 6 > column->capacity) {
+        size_t capacity = column->capacity ? column->capacity * 2 : 64;
+        unsigned char* data = (unsigned char*)realloc(column->data, capacity);
+        if (!data) {
+            writer->failed = 1;
+            return;
+        }
+        column->data = data;
+        column->capacity = capacity;
+    }
+
+    // Código num byte e comprimento em varint (7 bits por byte)
+    column->data[column->size++] = (unsigned char)code;
+    unsigned int value = (unsigned int)length;
+    while (value >= 0x80) {
+        column->data[column->size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    column->data[column->size++] = (unsigned char)value;
+}
+
+/* Row groups */
+static void write_group(ColumnarWriter* writer) {
+    if (writer->group_count == writer->group_capacity) {
+        int capacity = writer->group_capacity ? writer->group_capacity * 2 : 64;
+        RowGroup* groups = (RowGroup*)realloc(writer->groups, capacity * sizeof(RowGroup));
+        if (!groups) {
+            writer->failed = 1;
+            return;
+        }
+        writer->groups = groups;
+        writer->group_capacity = capacity;
+    }
+
+    int column_count = 0;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        Column* column = &writer->columns[slot];
+        if (!column->active) continue;
+        append_run(writer, column, column->code, writer->rows - column->run_start);
+        column_count++;
+    }
+
+    RowGroup* group = &writer->groups[writer->group_count++];
+    group->offset = ftell(writer->file);
+    group->first_time = writer->group_start;
+    group->rows = writer->rows;
+
+    write_int(writer, (int)COLUMNAR_GROUP_MAGIC);
+    write_int(writer, group->first_time);
+    write_int(writer, group->rows);
+    write_int(writer, column_count);
+
+    // Diretório ordenado por PID: o leitor procura uma coluna por pesquisa binária
+    size_t offset = 0;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        Column* column = &writer->columns[slot];
+        if (!column->active) continue;
+        write_int(writer, slot + 1);
+        write_int(writer, (int)offset);
+        write_int(writer, (int)column->size);
+        offset += column->size;
+    }
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        Column* column = &writer->columns[slot];
+        if (!column->active) continue;
+        if (column->size > 0 && fwrite(column->data, 1, column->size, writer->file) != column->size) {
+            writer->failed = 1;
+        }
+
+        // Quem já saiu não tem coluna no próximo row group
+        column->size = 0;
+        column->run_start = 0;
+        if (column->code == 0) column->active = 0;
+    }
+    writer->rows = 0;
+}
+
+/* Sink callbacks */
+static void columnar_transition(OutputSink* sink, const SimulationSystem* system,
+                                const PCB* process, int from, int to) {
+    ColumnarWriter* writer = (ColumnarWriter*)sink->ctx;
+    int slot = process->pid - 1;
+    (void)system;
+    (void)from;
+    if (writer->finished || slot < 0 || slot >= MAX_PROCESSES) return;
+
+    Column* column = &writer->columns[slot];
+    if (!column->active) {
+        // Vazia até aqui no row group atual
+        column->active = 1;
+        column->code = 0;
+        column->run_start = 0;
+    }
+    column->pending = to == NO_STATE ? 0 : to + 1;
+    if (!writer->is_dirty[slot]) {
+        writer->is_dirty[slot] = 1;
+        writer->dirty[writer->dirty_count++] = slot;
+    }
+}
+
+static void columnar_tick(OutputSink* sink, SimulationSystem* system) {
+    ColumnarWriter* writer = (ColumnarWriter*)sink->ctx;
+    if (writer->finished) return;
+
+    if (writer->rows == 0) writer->group_start = system->current_time;
+    int row = writer->rows;
+
+    // Só as colunas que mudaram neste tick: o custo não depende do nº de processos
+    for (int i = 0; i < writer->dirty_count; i++) {
+        int slot = writer->dirty[i];
+        Column* column = &writer->columns[slot];
+        writer->is_dirty[slot] = 0;
+        if (column->pending == column->code) continue;
+
+        append_run(writer, column, column->code, row - column->run_start);
+        column->code = column->pending;
+        column->run_start = row;
+    }
+    writer->dirty_count = 0;
+
+    if (++writer->rows == COLUMNAR_ROW_GROUP) {
+        write_group(writer);
+    }
+}
+
+static void columnar_finish(OutputSink* sink, SimulationSystem* system) {
+    ColumnarWriter* writer = (ColumnarWriter*)sink->ctx;
+    (void)system;
+    if (writer->finished) return;
+
+    if (writer->rows > 0) write_group(writer);
+
+    long footer = ftell(writer->file);
+    for (int g = 0; g < writer->group_count; g++) {
+        write_long(writer, writer->groups[g].offset);
+        write_int(writer, writer->groups[g].first_time);
+        write_int(writer, writer->groups[g].rows);
+    }
+    write_long(writer, footer);
+    write_int(writer, writer->group_count);
+    write_int(writer, (int)COLUMNAR_MAGIC);
+    if (fflush(writer->file) != 0) writer->failed = 1;
+    writer->finished = 1;
+}
+
+/* Lifecycle */
+OutputSink* columnar_open(const char* path) {
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    ColumnarWriter* writer = (ColumnarWriter*)calloc(1, sizeof(ColumnarWriter));
+    if (!sink || !writer) {
+        free(sink);
+        free(writer);
+        return NULL;
+    }
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        free(sink);
+        free(writer);
+        return NULL;
+    }
+
+    write_int(writer, (int)COLUMNAR_MAGIC);
+    write_int(writer, COLUMNAR_VERSION);
+    write_int(writer, NUM_STATES + 1);
+    write_int(writer, 0);   // Código 0: sem processo
+    for (int state = 0; state < NUM_STATES; state++) {
+        const char* name = state_name(state);
+        write_int(writer, (int)strlen(name));
+        if (fwrite(name, 1, strlen(name), writer->file) != strlen(name)) writer->failed = 1;
+    }
+
+    sink->on_transition = columnar_transition;
+    sink->on_tick = columnar_tick;
+    sink->on_finish = columnar_finish;
+    sink->ctx = writer;
+    return sink;
+}
+
+int columnar_close(OutputSink* sink) {
+    if (!sink) return 1;
+
+    ColumnarWriter* writer = (ColumnarWriter*)sink->ctx;
+    int ok = writer->finished && !writer->failed;
+    if (fclose(writer->file) != 0) ok = 0;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        free(writer->columns[slot].data);
+    }
+    free(writer->groups);
+    free(writer);
+    free(sink);
+    return ok;
+}
+
+/* Reading */
+ColumnarReader* columnar_reader_open(const char* path) {
+    ColumnarReader* reader = (ColumnarReader*)calloc(1, sizeof(ColumnarReader));
+    if (!reader) return NULL;
+
+    reader->file = fopen(path, "rb");
+    if (!reader->file) {
+        free(reader);
+        return NULL;
+    }
+
+    int magic = 0, version = 0;
+    int ok = read_int(reader->file, &magic) && (uint32_t)magic == COLUMNAR_MAGIC &&
+             read_int(reader->file, &version) && version == COLUMNAR_VERSION &&
+             read_int(reader->file, &reader->dictionary_size) &&
+             reader->dictionary_size > 0 && reader->dictionary_size <= MAX_CODES;
+    for (int code = 0; ok && code < reader->dictionary_size; code++) {
+        int length = 0;
+        ok = read_int(reader->file, &length) && length >= 0 && length < MAX_CODE_NAME &&
+             fread(reader->names[code], 1, length, reader->file) == (size_t)length;
+    }
+
+    long footer = 0;
+    ok = ok && fseek(reader->file, -TRAILER_SIZE, SEEK_END) == 0 &&
+         read_long(reader->file, &footer) && read_int(reader->file, &reader->group_count) &&
+         read_int(reader->file, &magic) && (uint32_t)magic == COLUMNAR_MAGIC &&
+         reader->group_count >= 0 && fseek(reader->file, footer, SEEK_SET) == 0;
+    if (ok && reader->group_count > 0) {
+        reader->groups = (RowGroup*)malloc(reader->group_count * sizeof(RowGroup));
+        ok = reader->groups != NULL;
+    }
+    for (int g = 0; ok && g < reader->group_count; g++) {
+        RowGroup* group = &reader->groups[g];
+        ok = read_long(reader->file, &group->offset) && read_int(reader->file, &group->first_time) &&
+             read_int(reader->file, &group->rows) && group->rows > 0;
+        reader->rows += group->rows;
+    }
+
+    if (!ok) {
+        columnar_reader_close(reader);
+        return NULL;
+    }
+    reader->first_time = reader->group_count > 0 ? reader->groups[0].first_time : 0;
+    return reader;
+}
+
+void columnar_reader_close(ColumnarReader* reader) {
+    if (!reader) return;
+
+    fclose(reader->file);
+    free(reader->groups);
+    free(reader);
+}
+
+int columnar_first_time(const ColumnarReader* reader) {
+    return reader->first_time;
+}
+
+long columnar_rows(const ColumnarReader* reader) {
+    return reader->rows;
+}
+
+const char* columnar_code_name(const ColumnarReader* reader, int code) {
+    return code >= 0 && code < reader->dictionary_size ? reader->names[code] : "?";
+}
+
+/**
+ * Finds the directory entry of pid in a row group (binary search on disk).
+ * Returns 1 and fills offset/size if the group has a column for it.
+ */
+static int find_column(ColumnarReader* reader, const RowGroup* group, int column_count,
+                       int pid, long* offset, int* size) {
+    long directory = group->offset + GROUP_HEADER_SIZE;
+    int low = 0, high = column_count - 1;
+
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        int entry_pid, entry_offset, entry_size;
+        if (fseek(reader->file, directory + (long)middle * DIRECTORY_ENTRY_SIZE, SEEK_SET) != 0 ||
+            !read_int(reader->file, &entry_pid) || !read_int(reader->file, &entry_offset) ||
+            !read_int(reader->file, &entry_size)) {
+            return 0;
+        }
+        if (entry_pid == pid) {
+            *offset = directory + (long)column_count * DIRECTORY_ENTRY_SIZE + entry_offset;
+            *size = entry_size;
+            return 1;
+        }
+        if (entry_pid < pid) low = middle + 1;
+        else high = middle - 1;
+    }
+    return 0;
+}
+
+long columnar_read_column(ColumnarReader* reader, int pid, unsigned char* codes, long max) {
+    unsigned char* chunk = NULL;
+    size_t chunk_capacity = 0;
+    long decoded = 0;
+
+    for (int g = 0; g < reader->group_count && decoded < max; g++) {
+        const RowGroup* group = &reader->groups[g];
+        int magic, first_time, rows, column_count;
+        if (fseek(reader->file, group->offset, SEEK_SET) != 0 ||
+            !read_int(reader->file, &magic) || (uint32_t)magic != COLUMNAR_GROUP_MAGIC ||
+            !read_int(reader->file, &first_time) || !read_int(reader->file, &rows) ||
+            !read_int(reader->file, &column_count) || rows != group->rows) {
+            free(chunk);
+            return -1;
+        }
+
+        long offset;
+        int size;
+        long row = 0;
+        if (find_column(reader, group, column_count, pid, &offset, &size) && size > 0) {
+            if ((size_t)size > chunk_capacity) {
+                unsigned char* grown = (unsigned char*)realloc(chunk, size);
+                if (!grown) {
+                    free(chunk);
+                    return -1;
+                }
+                chunk = grown;
+                chunk_capacity = size;
+            }
+            if (fseek(reader->file, offset, SEEK_SET) != 0 ||
+                fread(chunk, 1, size, reader->file) != (size_t)size) {
+                free(chunk);
+                return -1;
+            }
+
+            int position = 0;
+            while (position < size) {
+                int code = chunk[position++];
+                unsigned int length = 0;
+                int shift = 0;
+                while (position < size && shift < 32) {
+                    unsigned char byte = chunk[position++];
+                    length |= (unsigned int)(byte & 0x7f) << shift;
+                    shift += 7;
+                    if (!(byte & 0x80)) break;
+                }
+                for (unsigned int i = 0; i < length && row < rows; i++, row++) {
+                    if (decoded + row < max) codes[decoded + row] = (unsigned char)code;
+                }
+            }
+        }
+        // Sem coluna (ou runs em falta): o PID não existia
+        for (; row < rows; row++) {
+            if (decoded + row < max) codes[decoded + row] = 0;
+        }
+        decoded += rows;
+    }
+
+    free(chunk);
+    return decoded < max ? decoded : max;
+}
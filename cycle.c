@@ -0,0 +1,231 @@
+#include "include/cycle.h"
+#include "include/sink.h"
+
+/* State snapshot */
+static void put_queue(CycleSnapshot* snapshot, Queue* queue) {
+    snapshot->state[snapshot->size++] = queue ? (int32_t)queueSize(queue) : 0;
+    for (QueueNode* node = queue ? queue->front : NULL; node; node = node->next) {
+        snapshot->state[snapshot->size++] = ((PCB*)node->data)->pid;
+    }
+}
+
+/**
+ * Everything that decides the future, with times relative to now.
+ * Counters and absolute times (metrics, I/O sequence numbers) are left out.
+ */
+static void take_snapshot(const SimulationSystem* system, CycleSnapshot* snapshot) {
+    int now = system->current_time;
+    snapshot->time = now;
+    snapshot->size = 0;
+
+    snapshot->state[snapshot->size++] = system->next_pid;
+    snapshot->state[snapshot->size++] = system->running_process ? system->running_process->pid : 0;
+
+    for (int slot = procset_next(&system->live_set, 0); slot >= 0;
+         slot = procset_next(&system->live_set, slot + 1)) {
+        const PCB* proc = system->processes[slot];
+        int32_t* out = snapshot->state + snapshot->size;
+
+        out[0] = proc->pid;
+        out[1] = proc->program_id;
+        out[2] = proc->pc;
+        out[3] = proc->state;
+        out[4] = proc->remaining_quantum;
+        // Só conta para processos bloqueados em serviço
+        out[5] = proc->state == BLOCKED && proc->blocked_until >= 0 ? proc->blocked_until - now : -1;
+        out[6] = proc->time_in_state;
+        out[7] = proc->io_device;
+        out[8] = proc->io_service;
+        snapshot->size += 9;
+    }
+    snapshot->state[snapshot->size++] = -1;
+
+    put_queue(snapshot, system->new_queue);
+    put_queue(snapshot, system->ready_queue);
+    put_queue(snapshot, system->exit_queue);
+
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        const IoDevice* device = &system->io.devices[d];
+        if (!device->configured) continue;
+
+        snapshot->state[snapshot->size++] = device->busy;
+        put_queue(snapshot, device->wait_queue);
+    }
+
+    // Conclusões pendentes: ordem do heap e posição relativa de cada seq
+    const IoSubsystem* io = &system->io;
+    snapshot->state[snapshot->size++] = io->heap_size;
+    for (int i = 0; i < io->heap_size; i++) {
+        int rank = 0;
+        for (int j = 0; j < io->heap_size; j++) {
+            if (io->heap[j].seq < io->heap[i].seq) rank++;
+        }
+        snapshot->state[snapshot->size++] = io->heap[i].time - now;
+        snapshot->state[snapshot->size++] = io->heap[i].device;
+        snapshot->state[snapshot->size++] = ((PCB*)io->heap[i].data)->pid;
+        snapshot->state[snapshot->size++] = rank;
+    }
+
+    // FNV-1a sobre os inteiros
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (int i = 0; i < snapshot->size; i++) {
+        hash ^= (uint32_t)snapshot->state[i];
+        hash *= 0x100000001b3ull;
+    }
+    snapshot->hash = hash;
+}
+
+static int same_state(const CycleSnapshot* a, const CycleSnapshot* b) {
+    return a->hash == b->hash && a->size == b->size &&
+           memcmp(a->state, b->state, a->size * sizeof(int32_t)) == 0;
+}
+
+/* Eligibility */
+static int has_table_output(const SimulationSystem* system) {
+    return system->sink_count == 1 && system->sinks[0] == &table_output_sink;
+}
+
+static int can_skip(const SimulationSystem* system) {
+    return !system->arrivals && (system->sink_count == 0 || has_table_output(system));
+}
+
+/* Fast-forward */
+static void save_counters(CycleDetector* detector, const SimulationSystem* system) {
+    detector->metrics = system->metrics;
+    detector->rejected_injections = system->rejected_injections;
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        detector->device_counters[d][0] = system->io.devices[d].requests;
+        detector->device_counters[d][1] = system->io.devices[d].queued;
+        detector->device_counters[d][2] = system->io.devices[d].completed;
+    }
+}
+
+/**
+ * Advances system by `periods` whole periods: every counter grows by its
+ * change over the measured period, times shift and the measured rows are
+ * written again.
+ */
+static void skip_periods(CycleDetector* detector, SimulationSystem* system, int periods) {
+    int period = detector->period;
+    int shift = periods * period;
+    const SimulationMetrics* before = &detector->metrics;
+    SimulationMetrics* m = &system->metrics;
+
+    if (has_table_output(system) && detector->rows) {
+        FILE* out = system->output ? system->output : stdout;
+        for (int i = 0; i < shift; i++) {
+            print_state_row(out, system->current_time + 1 + i,
+                            detector->rows + (size_t)(i % period) * sizeof(system->row_cells));
+        }
+    }
+
+    for (int slot = 0; slot < m->processes_created && slot < MAX_PROCESSES; slot++) {
+        ProcessMetrics* pm = &m->processes[slot];
+        const ProcessMetrics* pb = &before->processes[slot];
+        for (int s = 0; s < NUM_STATES; s++) {
+            pm->ticks_in_state[s] += periods * (pm->ticks_in_state[s] - pb->ticks_in_state[s]);
+        }
+        pm->dispatches += periods * (pm->dispatches - pb->dispatches);
+        if (system->processes[slot]) {
+            pm->state_since += shift;
+        }
+    }
+    m->processes_finished += periods * (m->processes_finished - before->processes_finished);
+    m->total_turnaround += (long)periods * (m->total_turnaround - before->total_turnaround);
+    m->total_waiting += (long)periods * (m->total_waiting - before->total_waiting);
+    m->total_response += (long)periods * (m->total_response - before->total_response);
+    m->responded += periods * (m->responded - before->responded);
+    m->context_switches += periods * (m->context_switches - before->context_switches);
+    m->busy_ticks += periods * (m->busy_ticks - before->busy_ticks);
+    m->ticks += periods * (m->ticks - before->ticks);
+
+    system->rejected_injections += periods * (system->rejected_injections - detector->rejected_injections);
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        IoDevice* device = &system->io.devices[d];
+        device->requests += (long)periods * (device->requests - detector->device_counters[d][0]);
+        device->queued += (long)periods * (device->queued - detector->device_counters[d][1]);
+        device->completed += (long)periods * (device->completed - detector->device_counters[d][2]);
+    }
+
+    // Tempos absolutos
+    for (int slot = procset_next(&system->live_set, 0); slot >= 0;
+         slot = procset_next(&system->live_set, slot + 1)) {
+        if (system->processes[slot]->blocked_until >= 0) {
+            system->processes[slot]->blocked_until += shift;
+        }
+    }
+    for (int i = 0; i < system->io.heap_size; i++) {
+        system->io.heap[i].time += shift;
+    }
+    system->current_time += shift;
+    detector->skipped_ticks += shift;
+}
+
+void cycle_detector_init(CycleDetector* detector) {
+    memset(detector, 0, sizeof(CycleDetector));
+}
+
+void cycle_detector_free(CycleDetector* detector) {
+    free(detector->rows);
+    detector->rows = NULL;
+}
+
+void cycle_detector_reset(CycleDetector* detector) {
+    detector->filled = 0;
+    detector->period = 0;
+}
+
+long cycle_detector_tick(CycleDetector* detector, SimulationSystem* system) {
+    if (detector->done) return 0;
+    if (!can_skip(system)) {
+        cycle_detector_reset(detector);
+        return 0;
+    }
+
+    // A medir um período: guarda a linha e espera que feche
+    if (detector->period > 0) {
+        int offset = system->current_time - detector->measure_start - 1;
+        if (detector->rows) {
+            memcpy(detector->rows + (size_t)offset * sizeof(system->row_cells),
+                   system->row_cells, sizeof(system->row_cells));
+        }
+        if (offset + 1 < detector->period) return 0;
+
+        CycleSnapshot* now = &detector->history[detector->next];
+        take_snapshot(system, now);
+        if (!same_state(now, &detector->start)) {
+            cycle_detector_reset(detector);  // Não devia acontecer: volta a procurar
+            return 0;
+        }
+
+        int periods = (system->max_ticks - system->current_time) / detector->period;
+        long before = detector->skipped_ticks;
+        if (periods > 0 && (detector->rows || !has_table_output(system))) {
+            skip_periods(detector, system, periods);
+        }
+        detector->done = 1;
+        return detector->skipped_ticks - before;
+    }
+
+    CycleSnapshot* now = &detector->history[detector->next];
+    take_snapshot(system, now);
+
+    int count = detector->filled;
+    for (int i = 1; i <= count; i++) {
+        const CycleSnapshot* past = &detector->history[(detector->next - i + CYCLE_WINDOW) % CYCLE_WINDOW];
+        if (!same_state(now, past)) continue;
+
+        // Ciclo de período i: mede mais um período antes de saltar
+        detector->period = i;
+        detector->measure_start = system->current_time;
+        detector->start = *now;
+        save_counters(detector, system);
+        free(detector->rows);
+        detector->rows = has_table_output(system) ? (char*)malloc((size_t)i * sizeof(system->row_cells)) : NULL;
+        return 0;
+    }
+
+    detector->next = (detector->next + 1) % CYCLE_WINDOW;
+    if (detector->filled < CYCLE_WINDOW) detector->filled++;
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "include/devices.h"
+
+/* Setup */
+/**
+ * Initializes the subsystem with only device 0 (unlimited channels).
+ * Wait queues take their nodes from node_pool when it is not NULL.
+ */
+void io_init(IoSubsystem *io, ArenaPool *node_pool) {
+    io->node_pool = node_pool;
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        IoDevice *device = &io->devices[d];
+        device->configured = 0;
+        device->channels = 0;
+        device->busy = 0;
+        device->wait_queue = NULL;
+        device->requests = 0;
+        device->queued = 0;
+        device->completed = 0;
+    }
+    io->heap_size = 0;
+    io->next_seq = 0;
+    io_configure_device(io, 0, 0);
+}
+
+void io_destroy(IoSubsystem *io) {
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        if (io->devices[d].wait_queue) {
+            deleteQueue(io->devices[d].wait_queue);
+            io->devices[d].wait_queue = NULL;
+        }
+    }
+    io->heap_size = 0;
+}
+
+/**
+ * Configures a device with the given number of channels (0 = unlimited).
+ * Returns 1 on success, 0 for an invalid device.
+ */
+int io_configure_device(IoSubsystem *io, int device, int channels) {
+    if (device < 0 || device >= MAX_DEVICES || channels < 0) {
+        return 0;
+    }
+    if (!io->devices[device].wait_queue) {
+        io->devices[device].wait_queue = io->node_pool ? createPooledQueue(io->node_pool) : createQueue();
+        if (!io->devices[device].wait_queue) return 0;
+    }
+    io->devices[device].configured = 1;
+    io->devices[device].channels = channels;
+    return 1;
+}
+
+/* Requests */
+void io_decode(const IoSubsystem *io, int instruction, int *device, int *service) {
+    int amount = -instruction;
+    int target = amount / IO_DEVICE_STRIDE;
+
+    if (target > 0 && target < MAX_DEVICES && io->devices[target].configured) {
+        *device = target;
+        *service = amount % IO_DEVICE_STRIDE;
+        if (*service < 1) *service = 1;
+    } else {
+        *device = 0;
+        *service = amount;
+    }
+}
+
+/**
+ * Takes a free channel of the device. Returns 0 if all channels are busy.
+ */
+int io_acquire(IoSubsystem *io, int device) {
+    IoDevice *dev = &io->devices[device];
+
+    dev->requests++;
+    if (dev->channels == 0 || dev->busy < dev->channels) {
+        dev->busy++;
+        return 1;
+    }
+    dev->queued++;
+    return 0;
+}
+
+void io_wait(IoSubsystem *io, int device, void *data) {
+    enqueue(io->devices[device].wait_queue, data);
+}
+
+/**
+ * Hands the channel just released to the oldest waiting request, if any.
+ */
+void* io_next_waiting(IoSubsystem *io, int device) {
+    IoDevice *dev = &io->devices[device];
+    if (isEmpty(dev->wait_queue)) {
+        return NULL;
+    }
+    dev->busy++;
+    return dequeue(dev->wait_queue);
+}
+
+/* Completion heap */
+static int completion_before(const IoCompletion *a, const IoCompletion *b) {
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+void io_schedule(IoSubsystem *io, int device, void *data, int time) {
+    if (io->heap_size >= MAX_PROCESSES) return;
+
+    int i = io->heap_size++;
+    IoCompletion entry = {time, device, io->next_seq++, data};
+
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!completion_before(&entry, &io->heap[parent])) break;
+        io->heap[i] = io->heap[parent];
+        i = parent;
+    }
+    io->heap[i] = entry;
+}
+
+/**
+ * Time of the earliest completion, or -1 if nothing is in service.
+ */
+int io_next_completion(const IoSubsystem *io) {
+    return io->heap_size > 0 ? io->heap[0].time : -1;
+}
+
+/**
+ * Pops the earliest completion if it is due at `now` and releases its
+ * channel. Returns 1 and fills data/device, 0 if nothing is due.
+ */
+int io_pop_due(IoSubsystem *io, int now, void **data, int *device) {
+    if (io->heap_size == 0 || io->heap[0].time > now) {
+        return 0;
+    }
+
+    IoCompletion top = io->heap[0];
+    IoCompletion last = io->heap[--io->heap_size];
+    int i = 0;
+
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= io->heap_size) break;
+        if (child + 1 < io->heap_size && completion_before(&io->heap[child + 1], &io->heap[child])) {
+            child++;
+        }
+        if (!completion_before(&io->heap[child], &last)) break;
+        io->heap[i] = io->heap[child];
+        i = child;
+    }
+    if (io->heap_size > 0) {
+        io->heap[i] = last;
+    }
+
+    IoDevice *dev = &io->devices[top.device];
+    dev->busy--;
+    dev->completed++;
+
+    *data = top.data;
+    *device = top.device;
+    return 1;
+}
@@ -0,0 +1,672 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "include/harness.h"
+#include "include/simulation.h"
+#include "include/timer.h"
+#include "include/sink.h"
+#include "include/perf_counters.h"
+#include "include/sosim.h"
+#include "include/metrics.h"
+#include "include/checkpoint.h"
+#include "include/shm_ring.h"
+
+#ifdef _WIN32
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define BENCH_BATCHES 5
+#define BENCH_BATCH_NS 50000000ull  // Tempo mínimo de cada lote (50 ms)
+#define BENCH_MIN_RUNS 20
+#define CHECK_FORK_TICK 5           // Tick em que os modos de fork ramificam
+#define CHECK_MODE_RING "check.ring"
+#define CHECK_MODE_CACHE "check-cache"
+#define CHECK_RING_PATH "check-ring.shm"
+#define CHECK_SMALL_RING_PATH "check-small-ring.shm"
+#define CHECK_SMALL_RING 16         // Registos do anel que ultrapassa o leitor
+
+static const char* const golden_extensions[] = {".out", ".stats", ".json"};
+#define NUM_GOLDEN_EXTENSIONS ((int)(sizeof(golden_extensions) / sizeof(golden_extensions[0])))
+
+// Every mode must reproduce the default run exactly
+typedef struct {
+    const char* name;
+    char* args[5];
+    int cached;     // Sem trace; a segunda execução tem de vir toda da cache
+} CheckMode;
+
+static const CheckMode check_modes[] = {
+    {"default", {NULL}, 0},
+    {"skip-ahead", {"--skip-ahead", NULL}, 0},
+    {"fast-forward", {"--fast-forward", NULL}, 0},
+    {"async-output", {"--async-output", NULL}, 0},
+    {"span-index", {"--span-index", "--columnar", NULL}, 0},
+    {"shm-ring", {"--shm-ring", CHECK_MODE_RING, NULL}, 0},
+    {"checkpoint", {"--checkpoint-every", "50", "--checkpoint-path", "check-%06d.ckpt", NULL}, 0},
+    {"cache", {"--cache", CHECK_MODE_CACHE, NULL}, 1},
+};
+#define NUM_CHECK_MODES ((int)(sizeof(check_modes) / sizeof(check_modes[0])))
+
+/* Golden outputs */
+/**
+ * Compares two files line by line.
+ * Returns 0 if equal, otherwise prints the first differing line and returns 1.
+ */
+static int compare_files(const char* produced_path, const char* golden_path) {
+    FILE* produced = fopen(produced_path, "r");
+    FILE* golden = fopen(golden_path, "r");
+    int result = 0;
+
+    if (!produced || !golden) {
+        fprintf(stderr, "FAIL %s: missing %s\n", produced_path, produced ? golden_path : produced_path);
+        result = 1;
+    } else {
+        char produced_line[4096];
+        char golden_line[4096];
+        int line = 0;
+
+        while (1) {
+            char* a = fgets(produced_line, sizeof(produced_line), produced);
+            char* b = fgets(golden_line, sizeof(golden_line), golden);
+            line++;
+
+            if (!a && !b) break;
+            if (!a || !b || strcmp(a, b) != 0) {
+                fprintf(stderr, "FAIL %s: differs from %s at line %d\n", produced_path, golden_path, line);
+                fprintf(stderr, "  expected: %s", b ? b : "<eof>\n");
+                fprintf(stderr, "  got:      %s", a ? a : "<eof>\n");
+                result = 1;
+                break;
+            }
+        }
+    }
+
+    if (produced) fclose(produced);
+    if (golden) fclose(golden);
+    return result;
+}
+
+static int compare_outputs(const char* golden_dir, const char* mode, int extensions) {
+    int failures = 0;
+
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        for (int e = 0; e < extensions; e++) {
+            char produced_path[64];
+            char golden_path[1024];
+            snprintf(produced_path, sizeof(produced_path), "output%02d%s", i, golden_extensions[e]);
+            snprintf(golden_path, sizeof(golden_path), "%s/%s", golden_dir, produced_path);
+
+            if (compare_files(produced_path, golden_path)) {
+                fprintf(stderr, "     (mode %s)\n", mode);
+                failures++;
+            } else {
+                fprintf(stderr, "ok   %s (%s)\n", produced_path, mode);
+            }
+        }
+    }
+    return failures;
+}
+
+// Outputs left over from the previous mode must not pass for this one's
+static void remove_outputs(void) {
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        for (int e = 0; e < NUM_GOLDEN_EXTENSIONS; e++) {
+            char path[64];
+            snprintf(path, sizeof(path), "output%02d%s", i, golden_extensions[e]);
+            remove(path);
+        }
+    }
+}
+
+/* libsosim: the table rebuilt from the observer API must match the goldens */
+typedef struct {
+    char cells[MAX_PROCESSES * CELL_WIDTH];
+} ObservedRow;
+
+static void set_cell(char* cell, const char* state) {
+    size_t len = strlen(state);
+    cell[0] = '\t';
+    memcpy(cell + 1, state, len);
+    memset(cell + 1 + len, ' ', CELL_WIDTH - 1 - len);
+}
+
+static void observe_transition(void* ctx, const SimulationSystem* system, const PCB* process, int from, int to) {
+    ObservedRow* row = (ObservedRow*)ctx;
+    int slot = process->pid - 1;
+    (void)system;
+    (void)from;
+    if (slot < 0 || slot >= MAX_PROCESSES) return;
+
+    set_cell(row->cells + slot * CELL_WIDTH, to == NO_STATE ? "" : state_name(to));
+}
+
+/**
+ * Writes outputNN.out and outputNN.stats driving the engine only through
+ * sosim.h: the rows come from the observer's transitions, not the table
+ * sink. Returns 0 if the system or the files could not be created.
+ */
+static int run_library(int index) {
+    char out_path[64], stats_path[64];
+    snprintf(out_path, sizeof(out_path), "output%02d.out", index);
+    snprintf(stats_path, sizeof(stats_path), "output%02d.stats", index);
+
+    ObservedRow row;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        set_cell(row.cells + slot * CELL_WIDTH, "");
+    }
+    SimulationSystem* system = sosim_create(simulation_inputs[index]);
+    FILE* out = fopen(out_path, "w");
+    if (!system || !out || !sosim_add_observer(system, observe_transition, &row)) {
+        if (out) fclose(out);
+        sosim_destroy(system);
+        return 0;
+    }
+
+    fputs("time inst", out);
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        fprintf(out, "\tproc%d%s", i + 1, i + 1 < MAX_PROCESSES ? "\t" : "");
+    }
+    fputc('\n', out);
+
+    // Alterna sosim_step() e sosim_run_until() para testar os dois
+    int running = 1;
+    while (running && system->current_time < system->max_ticks) {
+        running = system->current_time % 2 ? sosim_step(system)
+                                           : sosim_run_until(system, system->current_time + 1);
+        print_state_row(out, system->current_time, row.cells);
+    }
+    fclose(out);
+
+    FILE* stats = fopen(stats_path, "w");
+    if (stats) {
+        print_simulation_summary(system, stats);
+        fclose(stats);
+    }
+    sosim_destroy(system);
+    return stats != NULL;
+}
+
+/* Forks: a branch taken mid-run must finish exactly like the run itself */
+// Initializes input index with its table going to outputNN.out
+static FILE* start_run(int index, SimulationSystem* system) {
+    char path[64];
+    snprintf(path, sizeof(path), "output%02d.out", index);
+    FILE* out = fopen(path, "w");
+    if (!out) return NULL;
+
+    initialize_system_with_input(system, simulation_inputs[index]);
+    system->output = out;
+    return out;
+}
+
+// Starts input index and runs it up to CHECK_FORK_TICK
+static FILE* start_fork_run(int index, SimulationSystem* system) {
+    FILE* out = start_run(index, system);
+    while (out && system->current_time < CHECK_FORK_TICK && simulation_step(system)) {
+    }
+    return out;
+}
+
+static void finish_run(int index, SimulationSystem* system) {
+    char path[64];
+    snprintf(path, sizeof(path), "output%02d.stats", index);
+
+    run_simulation(system);
+    FILE* stats = fopen(path, "w");
+    if (stats) {
+        print_simulation_summary(system, stats);
+        fclose(stats);
+    }
+}
+
+// simulation_fork(): the original keeps running (elsewhere) before the branch finishes
+static int run_fork(int index) {
+    SimulationSystem system, branch;
+    FILE* out = start_fork_run(index, &system);
+    if (!out) return 0;
+
+    int ok = simulation_fork(&system, &branch);
+    FILE* discard = fopen(NULL_DEVICE, "w");
+    if (discard) {
+        system.output = discard;
+        for (int i = 0; i < 10 && simulation_step(&system); i++) {
+        }
+    }
+    cleanup_simulation(&system);
+    if (discard) fclose(discard);
+
+    if (ok) {
+        finish_run(index, &branch);
+        cleanup_simulation(&branch);
+    }
+    fclose(out);
+    return ok;
+}
+
+// simulation_fork_process(): the child finishes the run, the parent only waits
+static int run_fork_process(int index) {
+#ifndef _WIN32
+    SimulationSystem system;
+    FILE* out = start_fork_run(index, &system);
+    if (!out) return 0;
+
+    int pid = simulation_fork_process(&system);
+    if (pid == 0) {
+        finish_run(index, &system);
+        fflush(NULL);
+        _exit(0);
+    }
+    int status = 0;
+    int ok = pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    cleanup_simulation(&system);
+    fclose(out);
+    return ok;
+#else
+    (void)index;
+    return 0;
+#endif
+}
+
+/* Shared-memory ring: readers must see exactly the run's transitions */
+typedef struct {
+    ShmRecord* records;
+    long count;
+    long capacity;
+    int failed;
+} RecordLog;
+
+static void log_record(OutputSink* sink, int type, int time, int pid, int from, int to, int program_id) {
+    RecordLog* log = (RecordLog*)sink->ctx;
+    if (log->count == log->capacity) {
+        long capacity = log->capacity ? 2 * log->capacity : 1024;
+        ShmRecord* records = (ShmRecord*)realloc(log->records, capacity * sizeof(ShmRecord));
+        if (!records) {
+            log->failed = 1;
+            return;
+        }
+        log->records = records;
+        log->capacity = capacity;
+    }
+    ShmRecord record = {type, time, pid, from, to, program_id};
+    log->records[log->count++] = record;
+}
+
+static void log_transition(OutputSink* sink, const SimulationSystem* system, const PCB* process, int from, int to) {
+    log_record(sink, SHM_RECORD_TRANSITION, system->current_time, process->pid, from, to, process->program_id);
+}
+
+static void log_tick(OutputSink* sink, SimulationSystem* system) {
+    log_record(sink, SHM_RECORD_TICK, system->current_time, 0, 0, 0, 0);
+}
+
+static void log_finish(OutputSink* sink, SimulationSystem* system) {
+    log_record(sink, SHM_RECORD_END, system->current_time, 0, 0, 0, 0);
+}
+
+static int same_record(const ShmRecord* a, const ShmRecord* b) {
+    return a->type == b->type && a->time == b->time && a->pid == b->pid && a->from == b->from &&
+           a->to == b->to && a->program_id == b->program_id;
+}
+
+/**
+ * Reads reader to the end and compares it with the last records of log.
+ * The reader may lag: it must then report exactly the records it lost.
+ */
+static int read_ring(ShmRingReader* reader, const RecordLog* log, long expected_lost, const char* name) {
+    ShmRecord record;
+    long position = 0;
+    long lost = 0;
+    long result;
+
+    while ((result = shm_ring_read(reader, &record)) != 0) {
+        if (result < 0) {
+            lost -= result;
+            position -= result;
+            continue;
+        }
+        if (position >= log->count || !same_record(&record, &log->records[position])) {
+            fprintf(stderr, "FAIL %s: record %ld differs from the run's\n", name, position);
+            return 0;
+        }
+        position++;
+    }
+    if (lost != expected_lost || position != log->count) {
+        fprintf(stderr, "FAIL %s: read %ld of %ld records, %ld lost (expected %ld)\n",
+                name, position - lost, log->count, lost, expected_lost);
+        return 0;
+    }
+    return 1;
+}
+
+// Runs input index publishing to a large ring and to a small one that laps its reader
+static int run_shm_ring(int index) {
+    SimulationSystem system;
+    FILE* out = start_run(index, &system);
+    if (!out) return 0;
+
+    RecordLog log = {NULL, 0, 0, 0};
+    OutputSink recorder = {log_transition, log_tick, log_finish, &log};
+    OutputSink* ring = shm_ring_open(CHECK_RING_PATH, SHM_RING_DEFAULT_CAPACITY);
+    OutputSink* small = shm_ring_open(CHECK_SMALL_RING_PATH, CHECK_SMALL_RING);
+    // Ligado antes da execução: fica mais de CHECK_SMALL_RING registos para trás
+    ShmRingReader* lagging = small ? shm_ring_attach(CHECK_SMALL_RING_PATH) : NULL;
+    int ok = ring && small && lagging;
+
+    if (ok) {
+        simulation_add_sink(&system, ring);
+        simulation_add_sink(&system, small);
+        simulation_add_sink(&system, &recorder);
+        finish_run(index, &system);
+        shm_ring_close(ring);
+        shm_ring_close(small);
+        ring = small = NULL;
+
+        ShmRingReader* reader = shm_ring_attach(CHECK_RING_PATH);
+        ok = !log.failed && reader && read_ring(reader, &log, 0, CHECK_RING_PATH) &&
+             read_ring(lagging, &log, log.count > CHECK_SMALL_RING ? log.count - CHECK_SMALL_RING : 0,
+                       CHECK_SMALL_RING_PATH);
+        shm_ring_detach(reader);
+    }
+    shm_ring_detach(lagging);
+    shm_ring_close(ring);
+    shm_ring_close(small);
+    cleanup_simulation(&system);
+    fclose(out);
+    free(log.records);
+    remove(CHECK_RING_PATH);
+    remove(CHECK_SMALL_RING_PATH);
+    return ok;
+}
+
+// Modes that run the engine directly instead of through the command line
+static int check_direct(const char* golden_dir, const char* mode, int (*run)(int index)) {
+    remove_outputs();
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        if (!run(i)) fprintf(stderr, "FAIL output%02d: %s run failed\n", i, mode);
+    }
+    return compare_outputs(golden_dir, mode, 2);
+}
+
+#ifndef _WIN32
+static void remove_matching(const char* dir, const char* prefix, const char* suffix) {
+    DIR* handle = opendir(dir);
+    if (!handle) return;
+
+    size_t prefix_len = strlen(prefix);
+    size_t suffix_len = strlen(suffix);
+    struct dirent* entry;
+    while ((entry = readdir(handle)) != NULL) {
+        const char* name = entry->d_name;
+        size_t len = strlen(name);
+        if (name[0] == '.' || len < prefix_len + suffix_len || strncmp(name, prefix, prefix_len) != 0 ||
+            strcmp(name + len - suffix_len, suffix) != 0) {
+            continue;
+        }
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        remove(path);
+    }
+    closedir(handle);
+}
+#endif
+
+// What the modes leave in the build directory: ring, checkpoints and cache
+static void remove_scratch(void) {
+    remove(CHECK_MODE_RING);
+#ifndef _WIN32
+    remove_matching(".", "check-", ".ckpt");
+    remove_matching(CHECK_MODE_CACHE, "", "");
+    rmdir(CHECK_MODE_CACHE);
+#endif
+}
+
+int harness_check_outputs(const char* golden_dir, HarnessRunFn run, void* ctx) {
+    int failures = 0;
+
+    for (int m = 0; m < NUM_CHECK_MODES; m++) {
+        const CheckMode* mode = &check_modes[m];
+        char** args = (char**)mode->args;
+
+        remove_outputs();
+        remove_scratch();
+        int simulated = run(args, !mode->cached, ctx);
+        if (simulated >= 0 && mode->cached) {
+            // A primeira execução guarda na cache (vazia), a segunda lê
+            remove_outputs();
+            simulated = run(args, 0, ctx);
+            if (simulated > 0) {
+                fprintf(stderr, "FAIL mode %s: %d input(s) not served from the cache\n", mode->name, simulated);
+                failures++;
+            }
+        }
+        remove_scratch();
+        if (simulated < 0) {
+            fprintf(stderr, "FAIL mode %s: options rejected\n", mode->name);
+            failures++;
+            continue;
+        }
+        failures += compare_outputs(golden_dir, mode->name, mode->cached ? 2 : NUM_GOLDEN_EXTENSIONS);
+    }
+
+    failures += check_direct(golden_dir, "libsosim", run_library);
+    failures += check_direct(golden_dir, "fork", run_fork);
+#ifndef _WIN32
+    failures += check_direct(golden_dir, "fork-process", run_fork_process);
+    failures += check_direct(golden_dir, "shm-read", run_shm_ring);
+#endif
+
+    fprintf(stderr, "%d golden file(s) differ\n", failures);
+    return failures;
+}
+
+/* Benchmark */
+/**
+ * Times one input in BENCH_BATCHES batches and keeps the fastest batch
+ * (ns per simulated tick), which is much less noisy than the mean.
+ */
+static double benchmark_input(int index, FILE* sink_file, long* runs_out) {
+    double best = 0.0;
+    long runs = 0;
+
+    for (int batch = 0; batch < BENCH_BATCHES; batch++) {
+        uint64_t elapsed = 0;
+        long ticks = 0;
+        long batch_runs = 0;
+
+        while (elapsed < BENCH_BATCH_NS || batch_runs < BENCH_MIN_RUNS) {
+            SimulationSystem system;
+
+            initialize_system_with_input(&system, simulation_inputs[index]);
+            system.output = sink_file;
+
+            uint64_t start = timer_now_ns();
+            run_simulation(&system);
+            elapsed += timer_now_ns() - start;
+
+            ticks += system.metrics.ticks;
+            batch_runs++;
+            cleanup_simulation(&system);
+        }
+
+        double per_tick = ticks > 0 ? (double)elapsed / ticks : 0.0;
+        if (batch == 0 || per_tick < best) best = per_tick;
+        runs += batch_runs;
+    }
+
+    *runs_out = runs;
+    return best;
+}
+
+static int load_baseline(const char* path, double baseline[NUM_INPUTS]) {
+    FILE* file = fopen(path, "r");
+    if (!file) return 0;
+
+    char line[256];
+    int loaded = 0;
+    while (fgets(line, sizeof(line), file)) {
+        int index;
+        double value;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "input%d %lf", &index, &value) == 2 && index >= 0 && index < NUM_INPUTS) {
+            baseline[index] = value;
+            loaded++;
+        }
+    }
+    fclose(file);
+    return loaded;
+}
+
+int harness_benchmark(const char* baseline_path, double threshold, int update_baseline) {
+    double baseline[NUM_INPUTS] = {0};
+    double results[NUM_INPUTS];
+    int regressions = 0;
+
+    FILE* sink_file = fopen(NULL_DEVICE, "w");
+    if (!sink_file) {
+        perror("Error opening " NULL_DEVICE);
+        return 1;
+    }
+
+    int have_baseline = !update_baseline && baseline_path && load_baseline(baseline_path, baseline) > 0;
+
+    printf("input\truns\tns/tick\tbaseline\tchange\n");
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        long runs;
+        results[i] = benchmark_input(i, sink_file, &runs);
+
+        printf("input%02d\t%ld\t%.1f", i, runs, results[i]);
+        if (have_baseline && baseline[i] > 0) {
+            double change = 100.0 * (results[i] - baseline[i]) / baseline[i];
+            int regressed = change > threshold;
+            printf("\t%.1f\t%+.1f%%%s", baseline[i], change, regressed ? "\tREGRESSION" : "");
+            regressions += regressed;
+        }
+        printf("\n");
+    }
+    fclose(sink_file);
+
+    if (update_baseline && baseline_path) {
+        FILE* file = fopen(baseline_path, "w");
+        if (!file) {
+            perror("Error writing baseline");
+            return 1;
+        }
+        fprintf(file, "# input ns_per_tick\n");
+        for (int i = 0; i < NUM_INPUTS; i++) {
+            fprintf(file, "input%02d %.1f\n", i, results[i]);
+        }
+        fclose(file);
+        printf("baseline written to %s\n", baseline_path);
+    } else if (have_baseline) {
+        printf("%d regression(s) above %.1f%%\n", regressions, threshold);
+    }
+
+    return regressions;
+}
+
+/* Hardware counters */
+static void count_transition(OutputSink* sink, const SimulationSystem* system, const PCB* process, int from, int to) {
+    (void)system;
+    (void)process;
+    (void)from;
+    (void)to;
+    (*(long*)sink->ctx)++;
+}
+
+// The run is deterministic: transitions are counted once, outside the measurement
+static long count_transitions(int index, FILE* sink_file) {
+    long transitions = 0;
+    OutputSink counter = {count_transition, NULL, NULL, &transitions};
+    SimulationSystem system;
+
+    initialize_system_with_input(&system, simulation_inputs[index]);
+    system.output = sink_file;
+    simulation_add_sink(&system, &counter);
+    transitions = 0;    // Sem o anúncio do processo inicial
+    run_simulation(&system);
+    cleanup_simulation(&system);
+    return transitions;
+}
+
+static void print_ratio(uint64_t value, int valid, double per) {
+    if (valid && per > 0) printf("\t%.2f", value / per);
+    else printf("\t-");
+}
+
+int harness_perf_counters(void) {
+    PerfCounters counters;
+    if (perf_counters_open(&counters) == 0) {
+        printf("perf: hardware counters unavailable (%s)\n",
+               counters.error ? strerror(counters.error) : "not supported");
+        return 0;
+    }
+
+    FILE* sink_file = fopen(NULL_DEVICE, "w");
+    if (!sink_file) {
+        perror("Error opening " NULL_DEVICE);
+        perf_counters_close(&counters);
+        return 1;
+    }
+
+    printf("input\truns\tcycles/tick\tinstr/tick\tIPC\tcache-miss/tick\tbranch-miss/tick"
+           "\tcycles/trans\tinstr/trans\tcache-miss/trans\tbranch-miss/trans\n");
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        uint64_t totals[NUM_PERF_COUNTERS] = {0};
+        int valid[NUM_PERF_COUNTERS];
+        long ticks = 0;
+        long runs = 0;
+        long transitions_per_run = count_transitions(i, sink_file);
+        uint64_t elapsed = 0;
+
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) valid[c] = 1;
+
+        // Só run_simulation() é contado, não a inicialização nem a limpeza
+        while (elapsed < BENCH_BATCH_NS || runs < BENCH_MIN_RUNS) {
+            SimulationSystem system;
+            PerfSample sample;
+
+            initialize_system_with_input(&system, simulation_inputs[i]);
+            system.output = sink_file;
+
+            uint64_t start = timer_now_ns();
+            perf_counters_start(&counters);
+            run_simulation(&system);
+            perf_counters_stop(&counters, &sample);
+            elapsed += timer_now_ns() - start;
+
+            for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+                totals[c] += sample.values[c];
+                valid[c] = valid[c] && sample.valid[c];
+            }
+            ticks += system.metrics.ticks;
+            runs++;
+            cleanup_simulation(&system);
+        }
+
+        double transitions = (double)transitions_per_run * runs;
+        printf("input%02d\t%ld", i, runs);
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            print_ratio(totals[c], valid[c], (double)ticks);
+            if (c == PERF_INSTRUCTIONS) {
+                print_ratio(totals[PERF_INSTRUCTIONS], valid[PERF_CYCLES] && valid[PERF_INSTRUCTIONS],
+                            (double)totals[PERF_CYCLES]);
+            }
+        }
+        for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+            print_ratio(totals[c], valid[c], transitions);
+        }
+        printf("\n");
+    }
+
+    for (int c = 0; c < NUM_PERF_COUNTERS; c++) {
+        if (counters.fds[c] < 0) printf("perf: %s unavailable\n", perf_counter_name(c));
+    }
+    fclose(sink_file);
+    perf_counters_close(&counters);
+    return 0;
+}
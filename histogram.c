@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include "include/histogram.h"
+
+typedef struct {
+    FILE* out;              // Não pertence ao histograma
+    int per_program;
+    int counts[5][NUM_STATES];  // Processos de cada programa em cada estado
+} Histogram;
+
+/* Sink callbacks */
+static void histogram_transition(OutputSink* sink, const SimulationSystem* system,
+                                 const PCB* process, int from, int to) {
+    Histogram* histogram = (Histogram*)sink->ctx;
+    int program = process->program_id;
+    (void)system;
+    if (program < 0 || program >= 5) return;
+
+    if (from != NO_STATE) histogram->counts[program][from]--;
+    if (to != NO_STATE) histogram->counts[program][to]++;
+}
+
+static void histogram_tick(OutputSink* sink, SimulationSystem* system) {
+    Histogram* histogram = (Histogram*)sink->ctx;
+    FILE* out = histogram->out;
+
+    fprintf(out, "%d", system->current_time);
+    for (int state = 0; state < NUM_STATES; state++) {
+        fprintf(out, "\t%d", system->state_counts[state]);
+    }
+    if (histogram->per_program) {
+        for (int program = 0; program < 5; program++) {
+            for (int state = 0; state < NUM_STATES; state++) {
+                fprintf(out, "\t%d", histogram->counts[program][state]);
+            }
+        }
+    }
+    fputc('\n', out);
+}
+
+/* Lifecycle */
+OutputSink* histogram_open(FILE* out, int per_program) {
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    Histogram* histogram = (Histogram*)calloc(1, sizeof(Histogram));
+    if (!out || !sink || !histogram) {
+        free(sink);
+        free(histogram);
+        return NULL;
+    }
+    histogram->out = out;
+    histogram->per_program = per_program;
+
+    fputs("time", out);
+    for (int state = 0; state < NUM_STATES; state++) {
+        fprintf(out, "\t%s", state_name(state));
+    }
+    if (per_program) {
+        for (int program = 0; program < 5; program++) {
+            for (int state = 0; state < NUM_STATES; state++) {
+                fprintf(out, "\tp%d %s", program, state_name(state));
+            }
+        }
+    }
+    fputc('\n', out);
+
+    sink->on_transition = histogram_transition;
+    sink->on_tick = histogram_tick;
+    sink->ctx = histogram;
+    return sink;
+}
+
+void histogram_close(OutputSink* sink) {
+    if (!sink) return;
+
+    free(sink->ctx);
+    free(sink);
+}
@@ -0,0 +1,41 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdio.h>
+#include "simulation.h"
+
+/*
+ * Static analysis of the loaded programs. Each program's control flow is
+ * deterministic (one successor per pc; an I/O instruction leaves pc where
+ * it is), so its path from pc 0 is a prefix followed either by a halt or
+ * by a loop it never leaves. EXECs on the prefix run once, EXECs inside
+ * the loop run forever. Following EXECs from program 0 gives the spawn
+ * graph and a bound on how many processes the workload creates.
+ */
+typedef struct {
+    int reachable;          // Criado (direta ou indiretamente) pelo programa 0
+    int terminates;
+    int loop_pc;            // Entrada do ciclo final (-1 se termina)
+    int loop_length;
+    int blocks_forever;     // O ciclo é uma instrução de I/O
+    int spawns[5];          // EXECs de cada programa executados uma vez
+    int spawns_in_loop;     // EXECs dentro do ciclo final
+    int loop_spawns[5];     // ... por programa criado
+} ProgramAnalysis;
+
+typedef struct {
+    ProgramAnalysis programs[5];
+    int unbounded;          // Criação sem fim (EXEC num ciclo ou ciclo no grafo de EXEC)
+    int non_terminating;    // Algum processo alcançável nunca sai
+    long total_processes;   // Processos criados sem o teto de PIDs (saturado; -1 = infinito)
+    int max_live;           // Limite de processos vivos em simultâneo
+    int max_queue_depth;    // Limite de qualquer fila (prontos, novos, espera de I/O)
+} WorkloadAnalysis;
+
+void analyze_workload(const SimulationSystem* system, WorkloadAnalysis* analysis);
+// Pre-allocates PCBs and queue nodes for the bound. external: processes
+// may also arrive from outside (trace, injections), so use the full table.
+int presize_system(SimulationSystem* system, const WorkloadAnalysis* analysis, int external);
+void print_workload_analysis(const WorkloadAnalysis* analysis, FILE* out);
+
+#endif /* ANALYSIS_H */
@@ -0,0 +1,43 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+#define ARENA_ALIGNMENT 16
+
+/*
+ * Per-run bump allocator. Objects are never freed individually: the whole
+ * arena goes away in one arena_release(). Fixed-size objects that are
+ * recycled during the run (PCBs, queue nodes) go through an ArenaPool,
+ * a free list on top of the arena.
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *blocks;     // Bloco atual à cabeça
+    size_t block_size;
+    size_t reserved;        // Total pedido ao malloc
+} Arena;
+
+typedef struct ArenaPool {
+    Arena *arena;
+    size_t object_size;
+    void *free_list;        // Objetos libertados (ligados pelo primeiro ponteiro)
+} ArenaPool;
+
+void arena_init(Arena *arena, size_t block_size);
+int arena_reserve(Arena *arena, size_t bytes);
+void* arena_alloc(Arena *arena, size_t size);
+void arena_release(Arena *arena);
+
+void arena_pool_init(ArenaPool *pool, Arena *arena, size_t object_size);
+int arena_pool_reserve(ArenaPool *pool, size_t count);
+void* arena_pool_alloc(ArenaPool *pool);
+void arena_pool_free(ArenaPool *pool, void *object);
+
+#endif /* ARENA_H */
@@ -0,0 +1,46 @@
+#ifndef ARRIVALS_H
+#define ARRIVALS_H
+
+#include <stdio.h>
+
+#define ARRIVAL_CHUNK 4096      // Registos lidos de cada vez
+
+/*
+ * Streaming reader for arrival traces: a text file with one
+ * "<arrival_time> <program_id>" record per line ('#' starts a comment),
+ * sorted by time; records with a negative time are skipped as bad. Only
+ * one chunk is held in memory at a time, so traces of any length use a
+ * constant amount of memory.
+ *
+ * PIDs are never reused and the table has MAX_PROCESSES of them, so a run
+ * admits at most MAX_PROCESSES processes in total, the inputs' initial
+ * processes included; later arrivals are rejected (with a warning on the
+ * first one) and counted in `rejected`.
+ */
+typedef struct {
+    int time;
+    int program_id;
+} Arrival;
+
+typedef struct {
+    FILE* file;
+    Arrival chunk[ARRIVAL_CHUNK];
+    int count;              // Registos válidos no chunk
+    int index;              // Próximo registo do chunk
+    int eof;
+    long line;              // Linha atual (para mensagens de erro)
+    int last_time;
+    long admitted;
+    long rejected;          // Programa inválido ou tabela de processos cheia
+    long out_of_order;      // Registos com tempo anterior ao do registo anterior
+} ArrivalStream;
+
+ArrivalStream* arrivals_open(const char* path);
+void arrivals_close(ArrivalStream* stream);
+
+// Time (>= 0) of the next pending arrival, or -1 once the trace is exhausted
+int arrivals_next_time(ArrivalStream* stream);
+// Returns the next arrival if it is due at or before `time` (and consumes it)
+int arrivals_pop_due(ArrivalStream* stream, int time, Arrival* arrival);
+
+#endif /* ARRIVALS_H */
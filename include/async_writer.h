@@ -0,0 +1,37 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ASYNC_WRITER_DEFAULT_BUFFER (4u << 20)   // Bytes de cada um dos dois buffers
+
+/*
+ * Asynchronous double-buffered output. The stream returned by
+ * async_writer_open() is an ordinary FILE*, so the table code is
+ * unchanged: its bytes go into the active buffer while a writer thread
+ * flushes the other one with one large positioned write (io_uring when the
+ * kernel allows it, pwrite otherwise).
+ *
+ * Backpressure: when the active buffer fills while the other is still
+ * being written, the simulation thread blocks until the writer is done;
+ * every such wait is counted in stalls/stall_ns, so a run that is bound
+ * by the disk says so instead of silently slowing down. fclose() writes
+ * what is left, joins the thread and fills *stats.
+ *
+ * Without fopencookie/pthreads (non-Linux builds) this is a plain fopen().
+ */
+typedef struct {
+    const char* backend;    // "io_uring", "pwrite" ou "stdio"
+    uint64_t bytes;
+    long buffers;           // Escritas feitas pela thread
+    long stalls;            // Vezes em que a simulação esperou pela thread
+    uint64_t stall_ns;
+    int failed;             // Erro de escrita (o ficheiro está incompleto)
+} AsyncWriterStats;
+
+// stats may be NULL; it must stay valid until fclose()
+FILE* async_writer_open(const char* path, size_t buffer_size, AsyncWriterStats* stats);
+
+#endif /* ASYNC_WRITER_H */
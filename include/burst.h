@@ -0,0 +1,29 @@
+#ifndef BURST_H
+#define BURST_H
+
+#include "simulation.h"
+
+/*
+ * Closed-form execution between events. While nothing but the running
+ * process changes (no NEW or EXIT processes, no completion or arrival due),
+ * every tick only moves its pc and quantum, and the table rows repeat. The
+ * burst executor walks the program once from pc to find how far it gets
+ * before an instruction with side effects (I/O, a spawning EXEC, halt);
+ * compute-only JUMP loops are reduced modulo their length. The skip-ahead
+ * engine then advances the whole span at once, including quantum renewals
+ * when no other process is ready and idle stretches where every process is
+ * blocked.
+ *
+ * Only the table output is reproduced for skipped ticks (other sinks
+ * disable skipping) and tracepoints do not fire for them. Processes
+ * submitted from other threads are admitted at the end of a skipped span.
+ */
+
+// Ticks (at most budget) proc can run from its pc without side effects;
+// *pc receives the pc after them. exec_spawns: whether EXEC creates a process.
+int burst_length(const PCB* proc, int budget, int exec_spawns, int* pc);
+
+// Advances system over the quiet ticks that follow; returns how many.
+int simulation_skip_ahead(SimulationSystem* system);
+
+#endif /* BURST_H */
@@ -0,0 +1,51 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "simulation.h"
+#include "sink.h"
+
+#define CHECKPOINT_MAGIC 0x4b43534fu    // "OSCK"
+#define CHECKPOINT_VERSION 1
+
+/*
+ * Compact binary snapshot of a SimulationSystem: time, programs, every
+ * live PCB (with its program copy), the order of every queue, device
+ * state and metrics. Sinks, the output file, the arrival trace and
+ * pending injections are not part of the snapshot.
+ */
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} CheckpointBuffer;
+
+void checkpoint_buffer_free(CheckpointBuffer* buffer);
+
+// Appends a snapshot of system to buffer. Returns 1 on success.
+int checkpoint_save(const SimulationSystem* system, CheckpointBuffer* buffer);
+// Rebuilds system (overwriting it) from a snapshot. Returns 1 on success.
+int checkpoint_restore(SimulationSystem* system, const unsigned char* data, size_t size);
+
+int checkpoint_write_file(const SimulationSystem* system, const char* path);
+int checkpoint_read_file(SimulationSystem* system, const char* path);
+
+// In-memory branch: dst becomes an independent copy of src, writing to
+// the same output but with only the default table sink
+int simulation_fork(const SimulationSystem* src, SimulationSystem* dst);
+// Copy-on-write branch of the whole program via fork(): 0 in the child,
+// the child's pid in the parent, -1 on error or where fork() is missing
+int simulation_fork_process(SimulationSystem* system);
+
+// Checkpoint file names: path_pattern is literal text with "%%" and exactly
+// one "%d" or "%0Nd" for the tick (e.g. "ckpt-%06d.bin"); nothing else is
+// accepted. checkpoint_path() returns 0 for an invalid pattern or if the
+// result does not fit.
+int checkpoint_pattern_valid(const char* path_pattern);
+int checkpoint_path(char* path, size_t size, const char* path_pattern, int tick);
+
+// Sink writing a checkpoint every `every` ticks to path_pattern (NULL if
+// the pattern is invalid)
+OutputSink* checkpoint_sink_open(int every, const char* path_pattern);
+void checkpoint_sink_close(OutputSink* sink);
+
+#endif /* CHECKPOINT_H */
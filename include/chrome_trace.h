@@ -0,0 +1,18 @@
+#ifndef CHROME_TRACE_H
+#define CHROME_TRACE_H
+
+#include "sink.h"
+
+#define CHROME_TRACE_TICK_US 1000   // 1 tick da simulação = 1 ms na timeline
+
+/*
+ * Chrome Trace Event / Perfetto JSON exporter.
+ *
+ * One track per PID (NEW/READY/RUN/BLOCKED/EXIT slices) under the
+ * "Processes" group and one track per simulated CPU under "CPU". Slices are
+ * written as soon as they end, so memory use does not grow with the trace.
+ */
+OutputSink* chrome_trace_open(const char* path);
+void chrome_trace_close(OutputSink* sink);
+
+#endif /* CHROME_TRACE_H */
@@ -0,0 +1,48 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "simulation.h"
+#include "sink.h"
+
+#define COLUMNAR_MAGIC 0x4f435353u        // "SSCO"
+#define COLUMNAR_GROUP_MAGIC 0x47435353u  // "SSCG"
+#define COLUMNAR_VERSION 1
+#define COLUMNAR_ROW_GROUP 4096           // Ticks por row group
+
+/*
+ * Columnar output: the same rows as the state table, stored one column
+ * per PID. Cell values are dictionary codes (0 = no process, 1 + state;
+ * the dictionary of names is in the file header) and every column is
+ * run-length encoded as (code byte, varint length) pairs, so a process
+ * that stays BLOCKED for a million ticks costs a few bytes.
+ *
+ * Rows are written in row groups of COLUMNAR_ROW_GROUP ticks as the run
+ * goes. A group only holds the columns of PIDs alive during it, with a
+ * directory sorted by PID, so a reader seeks straight to one column
+ * without decoding the others. A footer lists the groups.
+ *
+ * Layout: int32 magic, version, dictionary size, then (int32 length,
+ * name) per code; per group int32 magic, first time, rows, column count,
+ * (int32 pid, offset, size) per column and the column data; footer
+ * (int64 offset, int32 first time, int32 rows) per group; trailer int64
+ * footer offset, int32 group count, int32 magic.
+ */
+OutputSink* columnar_open(const char* path);
+// Returns 0 if the file could not be written completely
+int columnar_close(OutputSink* sink);
+
+// Reading
+typedef struct ColumnarReader ColumnarReader;
+
+ColumnarReader* columnar_reader_open(const char* path);
+void columnar_reader_close(ColumnarReader* reader);
+int columnar_first_time(const ColumnarReader* reader);
+long columnar_rows(const ColumnarReader* reader);
+// Name of a dictionary code ("" for no process)
+const char* columnar_code_name(const ColumnarReader* reader, int code);
+
+// Decodes the column of pid: codes[i] is the cell of time first_time + i
+// (at most max rows). Returns the rows decoded or -1 on error.
+long columnar_read_column(ColumnarReader* reader, int pid, unsigned char* codes, long max);
+
+#endif /* COLUMNAR_H */
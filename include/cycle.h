@@ -0,0 +1,53 @@
+#ifndef CYCLE_H
+#define CYCLE_H
+
+#include <stdint.h>
+#include "simulation.h"
+
+#define CYCLE_WINDOW 256    // Ticks de histórico: períodos maiores não são detetados
+#define CYCLE_STATE_INTS (8 + MAX_PROCESSES * 9 + 3 * (MAX_PROCESSES + 1) + \
+                          MAX_DEVICES * (MAX_PROCESSES + 2) + MAX_PROCESSES * 4)
+
+/*
+ * Steady-state detection. After every tick the part of the state that
+ * decides the future (PCBs, queue orders, pending I/O relative to now) is
+ * hashed and compared with the last CYCLE_WINDOW ticks. When it repeats
+ * with period P, one more period is simulated to measure the per-period
+ * change of every counter, and then whole periods are skipped: current
+ * time, pending completions and metrics advance arithmetically and the
+ * table rows of the measured period are written again with new times.
+ *
+ * Only runs whose inputs are all known in advance qualify (no arrival
+ * trace) and only the table output is reproduced: with other sinks
+ * registered nothing is skipped. Tracepoints do not fire for skipped ticks.
+ */
+typedef struct {
+    uint64_t hash;
+    int time;
+    int size;
+    int32_t state[CYCLE_STATE_INTS];
+} CycleSnapshot;
+
+struct CycleDetector {
+    CycleSnapshot history[CYCLE_WINDOW];
+    int next;               // Próxima posição do histórico (circular)
+    int filled;
+    int period;             // > 0 durante a medição de um período
+    int measure_start;
+    CycleSnapshot start;    // Estado no início da medição
+    SimulationMetrics metrics;
+    long device_counters[MAX_DEVICES][3];
+    int rejected_injections;
+    char* rows;             // Linhas da tabela do período medido
+    long skipped_ticks;
+    int done;
+};
+
+void cycle_detector_init(CycleDetector* detector);
+void cycle_detector_free(CycleDetector* detector);
+// Forgets the history (the tick sequence was interrupted, e.g. by a skip)
+void cycle_detector_reset(CycleDetector* detector);
+// Called after each tick of run_simulation(); returns the ticks skipped
+long cycle_detector_tick(CycleDetector* detector, SimulationSystem* system);
+
+#endif /* CYCLE_H */
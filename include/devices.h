@@ -0,0 +1,59 @@
+#ifndef DEVICES_H
+#define DEVICES_H
+
+#include "queue.h"
+#include "procset.h"
+
+#define MAX_DEVICES 8
+#define IO_DEVICE_STRIDE 1000   // I/O -(d*1000 + t): dispositivo d, serviço de t ticks
+
+/*
+ * I/O device subsystem. Each device has a number of parallel channels
+ * (0 = unlimited, i.e. every request is served at once) and a FIFO wait
+ * queue for requests that find all channels busy. Requests in service
+ * sit in one min-heap ordered by (completion time, submission order), so
+ * a tick only touches the completions that are actually due.
+ *
+ * Device 0 always exists with unlimited channels. An I/O instruction -N
+ * targets device N / 1000 with service N % 1000 when that device is
+ * configured; otherwise it is a plain N-tick wait on device 0.
+ */
+typedef struct {
+    int configured;
+    int channels;           // Canais em paralelo (0 = ilimitado)
+    int busy;               // Canais ocupados
+    Queue* wait_queue;      // Pedidos à espera de canal (FIFO)
+    long requests;
+    long queued;            // Pedidos que tiveram de esperar por canal
+    long completed;
+} IoDevice;
+
+typedef struct {
+    int time;               // Instante de conclusão
+    int device;
+    long seq;               // Ordem de submissão (desempate)
+    void *data;
+} IoCompletion;
+
+typedef struct {
+    IoDevice devices[MAX_DEVICES];
+    IoCompletion heap[MAX_PROCESSES]; // Cada processo tem no máximo um pedido em serviço
+    int heap_size;
+    long next_seq;
+    ArenaPool *node_pool;   // Pool dos nós das filas de espera (ou NULL)
+} IoSubsystem;
+
+void io_init(IoSubsystem *io, ArenaPool *node_pool);
+void io_destroy(IoSubsystem *io);
+int io_configure_device(IoSubsystem *io, int device, int channels);
+
+void io_decode(const IoSubsystem *io, int instruction, int *device, int *service);
+int io_acquire(IoSubsystem *io, int device);
+void io_wait(IoSubsystem *io, int device, void *data);
+void* io_next_waiting(IoSubsystem *io, int device);
+void io_schedule(IoSubsystem *io, int device, void *data, int time);
+
+int io_next_completion(const IoSubsystem *io);
+int io_pop_due(IoSubsystem *io, int now, void **data, int *device);
+
+#endif /* DEVICES_H */
@@ -0,0 +1,34 @@
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#define HARNESS_DEFAULT_THRESHOLD 25.0   // % de abrandamento tolerado no benchmark
+
+// Runs every input with the extra options in args (NULL-terminated), with
+// the Chrome trace if trace is set. Returns the number of inputs simulated
+// rather than read from the result cache, or -1 if the options are invalid.
+typedef int (*HarnessRunFn)(char** args, int trace, void* ctx);
+
+// Golden-output regression: runs the inputs in every mode (default,
+// --skip-ahead, --fast-forward, --async-output, ...) and compares
+// outputNN.{out,stats,json} in the current directory with the same
+// reference files in golden_dir. The --cache mode runs twice and checks
+// the second, cached, results. A last mode drives the engine only through
+// sosim.h and rebuilds the table from the observer's transitions, and
+// two more branch every run at CHECK_FORK_TICK with simulation_fork() and
+// simulation_fork_process() and let the branch finish it. The shm-read
+// mode attaches readers to the --shm-ring rings, one of them lapped, and
+// checks every record against the run's transitions.
+// Returns the number of mismatching/missing files.
+int harness_check_outputs(const char* golden_dir, HarnessRunFn run, void* ctx);
+
+// Performance regression: times every input and compares ns/tick with the
+// stored baseline (written instead when update_baseline is set).
+// Returns the number of inputs slower than baseline * (1 + threshold/100).
+int harness_benchmark(const char* baseline_path, double threshold, int update_baseline);
+
+// Hardware counters per simulated tick and per state transition for every
+// input (cycles, instructions, IPC, cache and branch misses). Prints a
+// notice and returns 0 when the counters are unavailable.
+int harness_perf_counters(void);
+
+#endif /* HARNESS_H */
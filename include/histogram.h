@@ -0,0 +1,19 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include "simulation.h"
+#include "sink.h"
+
+/*
+ * Aggregate output: instead of one column per process, each tick prints
+ * how many processes are in each state, optionally followed by the same
+ * counts per program id. The totals are the counters the engine already
+ * keeps per state; the per-program counts are updated at each transition,
+ * so neither depends on how many processes exist.
+ *
+ * Row: time, then NEW READY RUN BLOCKED EXIT (and 5 more per program).
+ */
+OutputSink* histogram_open(FILE* out, int per_program);
+void histogram_close(OutputSink* sink);
+
+#endif /* HISTOGRAM_H */
@@ -0,0 +1,25 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stdio.h>
+#include "simulation.h"
+
+/*
+ * Incremental re-simulation: after a workload edit, the run is resumed from
+ * the previous run's latest periodic checkpoint taken before any process of
+ * an edited program was created. Until that tick the edited programs cannot
+ * have influenced the state, so the earlier output rows are kept as they are.
+ */
+
+// Finds the latest checkpoint (pattern takes the tick, one every `every`
+// ticks up to max_ticks) that the edited program table does not affect,
+// restores it into system and installs the edited programs. Returns the
+// checkpoint's tick, or -1 if none applies (system is then left cleaned up).
+int incremental_resume(SimulationSystem* system, const int programs[5][MAX_INSTRUCTIONS],
+                       const int lengths[5], const char* pattern, int every, int max_ticks);
+
+// Cuts a previous table output after the header and `ticks` rows and
+// positions file at the end, ready to append. Returns 1 on success.
+int incremental_reuse_prefix(FILE* file, int ticks);
+
+#endif /* INCREMENTAL_H */
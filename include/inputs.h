@@ -15,4 +15,6 @@ typedef struct {
     int rows;
 } SimulationInput;
 
+extern SimulationInput simulation_inputs[NUM_INPUTS];
+
 #endif
\ No newline at end of file
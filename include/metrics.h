@@ -0,0 +1,14 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "simulation.h"
+
+// Incremental bookkeeping (called from simulation.c)
+void metrics_process_created(SimulationSystem* system, const PCB* process);
+void metrics_transition(SimulationSystem* system, const PCB* process, int from, int to);
+void metrics_tick(SimulationSystem* system);
+
+// Summary
+void print_simulation_summary(const SimulationSystem* system, FILE* out);
+
+#endif /* METRICS_H */
@@ -0,0 +1,26 @@
+#ifndef MPSC_H
+#define MPSC_H
+
+#include <stdatomic.h>
+
+/*
+ * Lock-free multi-producer / single-consumer queue (intrusive, Vyukov
+ * style). Producers never block or spin on each other: a push is one
+ * atomic exchange plus one store. Only one thread may call mpscPop().
+ */
+typedef struct MpscNode {
+    _Atomic(struct MpscNode*) next;
+} MpscNode;
+
+typedef struct {
+    _Atomic(MpscNode*) head;    // Último nó inserido (produtores)
+    MpscNode* tail;             // Próximo nó a retirar (consumidor)
+    MpscNode stub;
+} MpscQueue;
+
+MpscQueue* createMpscQueue();
+void mpscPush(MpscQueue *queue, MpscNode *node);
+MpscNode* mpscPop(MpscQueue *queue);
+void deleteMpscQueue(MpscQueue *queue);
+
+#endif /* MPSC_H */
@@ -0,0 +1,41 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdint.h>
+
+/*
+ * Hardware performance counters (perf_event_open, user space only) for
+ * the code between perf_counters_start() and perf_counters_stop() in the
+ * calling thread. Each counter is opened on its own, so a PMU without,
+ * say, cache events still reports the others; values are scaled when the
+ * kernel multiplexes them. Without perf (other systems, no PMU in a VM,
+ * perf_event_paranoid too high) nothing is available and every read is
+ * reported as missing.
+ */
+enum PERF_COUNTER_IDS {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    NUM_PERF_COUNTERS
+};
+
+typedef struct {
+    int fds[NUM_PERF_COUNTERS];     // -1 = indisponível
+    int error;                      // errno da primeira falha (0 = nenhuma)
+} PerfCounters;
+
+typedef struct {
+    uint64_t values[NUM_PERF_COUNTERS];
+    int valid[NUM_PERF_COUNTERS];
+} PerfSample;
+
+// Returns how many counters could be opened
+int perf_counters_open(PerfCounters* counters);
+void perf_counters_close(PerfCounters* counters);
+void perf_counters_start(PerfCounters* counters);
+void perf_counters_stop(PerfCounters* counters, PerfSample* sample);
+
+const char* perf_counter_name(int counter);
+
+#endif /* PERF_COUNTERS_H */
@@ -0,0 +1,96 @@
+#ifndef PROCSET_H
+#define PROCSET_H
+
+#include <stdint.h>
+
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES 20        // Número máximo de processos (slots da tabela)
+#endif
+
+#define PROCSET_WORDS ((MAX_PROCESSES + 63) / 64)
+
+// Bitset de slots de processos (slot = pid - 1)
+typedef struct {
+    uint64_t words[PROCSET_WORDS];
+} ProcessSet;
+
+static inline int procset_bit_count(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    int count = 0;
+    while (word) {
+        word &= word - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+static inline int procset_lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int index = 0;
+    while (!(word & 1)) {
+        word >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+static inline void procset_add(ProcessSet *set, int slot) {
+    set->words[slot >> 6] |= (uint64_t)1 << (slot & 63);
+}
+
+static inline void procset_remove(ProcessSet *set, int slot) {
+    set->words[slot >> 6] &= ~((uint64_t)1 << (slot & 63));
+}
+
+static inline int procset_contains(const ProcessSet *set, int slot) {
+    return (int)((set->words[slot >> 6] >> (slot & 63)) & 1);
+}
+
+static inline void procset_clear(ProcessSet *set) {
+    for (int i = 0; i < PROCSET_WORDS; i++) {
+        set->words[i] = 0;
+    }
+}
+
+static inline int procset_is_empty(const ProcessSet *set) {
+    for (int i = 0; i < PROCSET_WORDS; i++) {
+        if (set->words[i]) return 0;
+    }
+    return 1;
+}
+
+static inline int procset_count(const ProcessSet *set) {
+    int count = 0;
+    for (int i = 0; i < PROCSET_WORDS; i++) {
+        count += procset_bit_count(set->words[i]);
+    }
+    return count;
+}
+
+/**
+ * Returns the first slot >= start present in the set, or -1 if none.
+ * Iterate with: for (s = procset_next(set, 0); s >= 0; s = procset_next(set, s + 1))
+ */
+static inline int procset_next(const ProcessSet *set, int start) {
+    if (start >= MAX_PROCESSES) return -1;
+
+    int word_index = start >> 6;
+    uint64_t word = set->words[word_index] & (~(uint64_t)0 << (start & 63));
+
+    while (1) {
+        if (word) {
+            int slot = (word_index << 6) + procset_lowest_bit(word);
+            return slot < MAX_PROCESSES ? slot : -1;
+        }
+        if (++word_index >= PROCSET_WORDS) return -1;
+        word = set->words[word_index];
+    }
+}
+
+#endif /* PROCSET_H */
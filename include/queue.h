@@ -2,6 +2,7 @@
 #define QUEUE_H
 
 #include <stdlib.h>
+#include "arena.h"
 
 // Queue Node structure
 typedef struct QueueNode {
@@ -14,10 +15,12 @@ typedef struct {
     QueueNode *front;
     QueueNode *rear;
     size_t size;
+    ArenaPool *node_pool;   // NULL: nós com malloc/free
 } Queue;
 
 // Queue Operations
 Queue* createQueue();
+Queue* createPooledQueue(ArenaPool *node_pool);
 void enqueue(Queue *queue, void *data);
 void* dequeue(Queue *queue);
 int isEmpty(Queue *queue);
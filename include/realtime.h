@@ -0,0 +1,42 @@
+#ifndef REALTIME_H
+#define REALTIME_H
+
+#include "simulation.h"
+
+#define RT_MAX_CLIENTS 8
+#define RT_MAX_COMMANDS_PER_TICK 16  // Limite de comandos tratados por tick
+#define RT_LINE_MAX 512
+
+/*
+ * Real-time paced mode: ticks advance at tick_hz against the monotonic
+ * clock while local clients talk to the simulation over a Unix domain
+ * socket, one command per line:
+ *
+ *   SPAWN <prog>                  create a process of program <prog>
+ *   PROGRAM <prog> <i0> <i1> ...  replace program <prog> (max 20 values)
+ *   STATE                         current time, counters and PID states
+ *   QUIT                          stop the simulation
+ *
+ * Every command gets a one-line reply ("OK", "ERR <reason>" or the state).
+ * PIDs are never reused, so SPAWN replies "ERR table full" once the
+ * MAX_PROCESSES PIDs are taken (counting spawns still waiting for the next
+ * tick); an "OK" process is always created.
+ * The simulation keeps running while empty, until QUIT or max_ticks
+ * (0 = no limit).
+ */
+typedef struct {
+    double tick_hz;
+    const char* socket_path;
+    int max_ticks;
+} RealtimeConfig;
+
+typedef struct {
+    int ticks;
+    int late_ticks;         // Ticks que acabaram depois do prazo
+    long commands;
+} RealtimeStats;
+
+// Returns 0 on a clean stop, -1 if the socket could not be set up
+int run_realtime(SimulationSystem* system, const RealtimeConfig* config, RealtimeStats* stats);
+
+#endif /* REALTIME_H */
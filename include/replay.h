@@ -0,0 +1,54 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdio.h>
+#include "simulation.h"
+#include "sink.h"
+
+#define REPLAY_MAGIC 0x50525353u    // "SSRP"
+#define REPLAY_VERSION 1
+#define REPLAY_DEFAULT_KEYFRAME_EVERY 1000
+
+/*
+ * Replay log: every external input (spawn requests, arrivals, program
+ * changes), every scheduling decision and a checkpoint keyframe every N
+ * ticks, followed on close by an index of the keyframes. Since the
+ * simulation is deterministic, restoring a keyframe and feeding the logged
+ * inputs back reproduces the run; seeking to T costs at most N ticks.
+ *
+ * Record layout: int32 type, int32 time, int32 arg, then a payload for
+ * PROGRAM (count + instructions) and KEYFRAME (checkpoint size + bytes).
+ */
+enum {
+    REPLAY_SPAWN = 1,       // arg = program id (admitted during tick `time`)
+    REPLAY_PROGRAM,         // arg = program id (applied before tick `time`)
+    REPLAY_SCHEDULE,        // arg = dispatched pid
+    REPLAY_KEYFRAME,        // state after tick `time`
+    REPLAY_END,
+    REPLAY_INDEX
+};
+
+// Recording: attach before the run, close after it
+ReplayLog* replay_log_open(const char* path, int keyframe_every);
+int replay_log_attach(ReplayLog* log, SimulationSystem* system);
+void replay_log_close(ReplayLog* log, SimulationSystem* system);
+
+void replay_record_spawn(ReplayLog* log, int time, int program_id);
+void replay_record_program(ReplayLog* log, int time, int prog_id, const int* instructions, int count);
+
+// Playback
+typedef struct ReplayReader ReplayReader;
+
+ReplayReader* replay_open(const char* path);
+void replay_close(ReplayReader* reader);
+
+// Restores the nearest keyframe at or before time and replays up to it.
+// Returns the keyframe's tick, or -1 on error.
+int replay_seek(ReplayReader* reader, SimulationSystem* system, int time);
+// Feeds the logged inputs for the next tick and runs it. Returns 0 once
+// the recorded run has ended.
+int replay_step(ReplayReader* reader, SimulationSystem* system);
+// Ticks whose dispatch did not match the log
+long replay_divergences(const ReplayReader* reader);
+
+#endif /* REPLAY_H */
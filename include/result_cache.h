@@ -0,0 +1,37 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdint.h>
+#include "simulation.h"
+
+#define RESULT_CACHE_MAGIC 0x48435253u      // "SRCH"
+#define RESULT_CACHE_DEFAULT_MB 64
+
+/*
+ * On-disk cache of finished runs, addressed by a hash of everything that
+ * determines the output: engine version, decoded programs, tick limit and
+ * device configuration. Entries are written to a temporary file and
+ * renamed into place, so concurrent workers sharing a directory never see
+ * a partial entry. A hit refreshes the entry's mtime; stores evict the
+ * least recently used entries beyond the size limit.
+ */
+typedef struct {
+    int32_t engine_version;
+    int32_t max_processes;
+    int32_t max_ticks;
+    int32_t programs[5][MAX_INSTRUCTIONS];
+    int32_t program_lengths[5];
+    int32_t devices[MAX_DEVICES][2];    // configured, channels
+} ResultCacheKey;
+
+// Key of a system that is initialized but has not run yet
+void result_cache_key(const SimulationSystem* system, ResultCacheKey* key);
+
+// Copies a stored result to out_path/stats_path. Returns 1 on a hit.
+int result_cache_lookup(const char* dir, const ResultCacheKey* key,
+                        const char* out_path, const char* stats_path);
+// Stores the files of a finished run. Returns 1 on success.
+int result_cache_store(const char* dir, long max_bytes, const ResultCacheKey* key,
+                       const char* out_path, const char* stats_path);
+
+#endif /* RESULT_CACHE_H */
@@ -0,0 +1,66 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "sink.h"
+
+#define SHM_RING_MAGIC 0x534f5352u      // "SOSR"
+#define SHM_RING_VERSION 1
+#define SHM_RING_DEFAULT_CAPACITY 65536 // Registos (potência de 2)
+
+enum SHM_RECORD_TYPES {SHM_RECORD_TRANSITION, SHM_RECORD_TICK, SHM_RECORD_END};
+
+/*
+ * Single-producer / multi-consumer ring of transition records in a shared
+ * mmap'd file (e.g. under /dev/shm). The producer never waits for readers:
+ * each slot is a small seqlock, so a reader that falls more than
+ * `capacity` records behind just detects the overrun and skips ahead.
+ */
+typedef struct {
+    _Atomic uint64_t seq;       // 2n+1 enquanto o registo n é escrito, 2n+2 quando pronto
+    _Atomic int32_t type;
+    _Atomic int32_t time;
+    _Atomic int32_t pid;        // SHM_RECORD_TRANSITION
+    _Atomic int32_t from;
+    _Atomic int32_t to;
+    _Atomic int32_t program_id;
+} ShmRingSlot;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    _Atomic uint64_t write_seq; // Nº de registos publicados
+} ShmRingHeader;
+
+typedef struct {
+    int type;
+    int time;
+    int pid;
+    int from;
+    int to;
+    int program_id;
+} ShmRecord;
+
+typedef struct {
+    ShmRingHeader* header;
+    ShmRingSlot* slots;
+    size_t mapped_size;
+    uint64_t cursor;            // Próximo registo a ler
+} ShmRingReader;
+
+// Producer side: an output sink publishing to the ring at path
+OutputSink* shm_ring_open(const char* path, uint32_t capacity);
+void shm_ring_close(OutputSink* sink);
+
+// Consumer side
+ShmRingReader* shm_ring_attach(const char* path);
+// Returns 1 and fills record, 0 if nothing new, or -N if N records were lost
+long shm_ring_read(ShmRingReader* reader, ShmRecord* record);
+// Same, but polls for up to timeout_ms while nothing is new
+long shm_ring_read_wait(ShmRingReader* reader, ShmRecord* record, int timeout_ms);
+void shm_ring_detach(ShmRingReader* reader);
+
+#endif /* SHM_RING_H */
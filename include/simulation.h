@@ -5,57 +5,154 @@
 #include "queue.h"
 #include "inputs.h"
 #include "string.h"
+#include "procset.h"
+#include "mpsc.h"
+#include "arrivals.h"
+#include "devices.h"
+#include "arena.h"
 
 enum STATES {NEW, READY, RUNNING, BLOCKED, EXIT};
+#define NUM_STATES 5
 #define NUM_INPUTS 6
 
+#define NO_STATE (-1)          // "Estado" antes da criação / depois da remoção
+#define CELL_WIDTH 9            // "\t" + estado alinhado a 8 caracteres
+#define MAX_INSTRUCTIONS 20     // Instruções por programa
+#define DEFAULT_MAX_TICKS 100   // Duração máxima de uma simulação
+#define MAX_SINKS 8             // Nº máximo de saídas registadas por simulação
+#define QUANTUM 3               // Ticks de CPU por despacho
+#define SIM_ENGINE_VERSION 1    // Incrementar quando a semântica ou o formato da saída mudam
+
+typedef struct OutputSink OutputSink;
+typedef struct ReplayLog ReplayLog;
+typedef struct CycleDetector CycleDetector;
+typedef struct PhaseProfiler PhaseProfiler;
+
 typedef struct {
     int pid;
     int program_id;
     int pc;
     int state;              // Estado atual
     int remaining_quantum;  // Tempo restante no quantum
-    int blocked_until;
+    int blocked_until;      // Fim do serviço de I/O (-1 enquanto espera por canal)
+    int io_device;          // Dispositivo do último pedido de I/O
+    int io_service;         // Duração do serviço pedido
     int time_in_state;      // Tempo no estado atual - NEW,EXIT
     int* instructions;      // pointer para as instruções do programa
     int instruction_count;  // Número de instruções do programa
 } PCB;
 
+// Pedido de criação de processo submetido por uma thread externa
+typedef struct {
+    MpscNode node;          // Tem de ser o primeiro campo
+    int program_id;
+} SpawnRequest;
+
+// Métricas de escalonamento de um processo (indexadas por slot = pid - 1)
+typedef struct {
+    int program_id;
+    int arrival_time;       // Instante de criação
+    int first_run_time;     // Primeiro instante em RUNNING (-1 se nunca correu)
+    int finish_time;        // Instante de entrada em EXIT (-1 se não terminou)
+    int state_since;        // Instante de entrada no estado atual
+    int ticks_in_state[NUM_STATES]; // Tempo acumulado em cada estado
+    int dispatches;         // Nº de vezes que passou a RUNNING
+} ProcessMetrics;
+
+// Métricas agregadas de uma execução, atualizadas em cada transição
+typedef struct {
+    ProcessMetrics processes[MAX_PROCESSES];
+    int processes_created;
+    int processes_finished;
+    long total_turnaround;  // Soma de (finish - arrival) dos terminados
+    long total_waiting;     // Soma do tempo em READY dos terminados
+    long total_response;    // Soma de (first_run - arrival) dos que correram
+    int responded;          // Nº de processos que chegaram a correr
+    int context_switches;   // Nº de despachos para RUNNING
+    int busy_ticks;         // Instantes com um processo em RUNNING
+    int ticks;              // Instantes simulados
+} SimulationMetrics;
+
 typedef struct {
     Queue* new_queue;
     Queue* ready_queue;
-    Queue* blocked_queue;
+    IoSubsystem io;         // Dispositivos de I/O (processos em BLOCKED)
     Queue* exit_queue;
     PCB* running_process;   // Processo em RUNNING
-    PCB* processes[20];     // Array de todos os processos (máx 20)
+    PCB* processes[MAX_PROCESSES]; // Array de todos os processos (máx 20)
     int next_pid;           // Próximo PID a ser atribuído
     int current_time;       // Instante atual da simulação
+    int max_ticks;          // Último instante simulado por run_simulation()
     int programs[5][20];    // Programas disponíveis (como no enunciado)
     int program_counts[5];  // instruction counts
     int program_lengths[5]; // Tamanhos dos programas
+
+    ProcessSet live_set;                 // Slots ocupados (qualquer estado)
+    ProcessSet state_sets[NUM_STATES];   // Slots em cada estado
+    int state_counts[NUM_STATES];        // Nº de processos em cada estado
+    ProcessSet dirty_set;                // Slots alterados desde o último print
+    char row_cells[MAX_PROCESSES * CELL_WIDTH]; // Última linha impressa (sem o tempo)
+
+    SimulationMetrics metrics;
+
+    OutputSink* sinks[MAX_SINKS]; // Saídas notificadas das transições/ticks
+    int sink_count;
+    FILE* output;           // Destino da tabela de estados (stdout por omissão)
+
+    MpscQueue* injection_queue; // Processos submetidos por outras threads
+    int rejected_injections;    // Pedidos descartados (programa inválido/tabela cheia)
+    ArrivalStream* arrivals;    // Trace de chegadas (opcional, não pertence ao sistema)
+    ReplayLog* replay_log;      // Regista as entradas externas (opcional)
+    CycleDetector* cycle_detector; // Salta períodos de um estado cíclico (opcional)
+    int skip_ahead;             // Avança de uma vez os ticks sem eventos
+    PhaseProfiler* profiler;    // Tempo de cada fase do tick (opcional)
+
+    Arena arena;                // Memória da execução (PCBs, filas e nós)
+    ArenaPool process_pool;     // PCBs + cópia do programa, reciclados ao sair
+    ArenaPool node_pool;        // QueueNodes de todas as filas
 } SimulationSystem;
 
 //System Simulation
+void initialize_system(SimulationSystem* system);
 void initialize_system_with_input(SimulationSystem* system, SimulationInput input);
 void run_simulation(SimulationSystem* system);
+int simulation_step(SimulationSystem* system);
+int set_program(SimulationSystem* system, int prog_id, const int* instructions, int count);
+void cleanup_simulation(SimulationSystem* system);
 
 //Queue operation/interaction
 void update_blocked_processes(SimulationSystem* system);
 void update_new_processes(SimulationSystem* system);
 void update_exit_processes(SimulationSystem* system);
 
+//External process injection
+int submit_process(SimulationSystem* system, int program_id);
+void drain_injected_processes(SimulationSystem* system);
+void admit_arrivals(SimulationSystem* system);
+
 //Instruction/Process Execution
 void execute_instruction(SimulationSystem* system, PCB* proc, int instruction);
 void execute_running_process(SimulationSystem* system);
 
+//State bookkeeping
+void index_process(SimulationSystem* system, PCB* process);
+void track_process(SimulationSystem* system, PCB* process);
+void untrack_process(SimulationSystem* system, PCB* process);
+void set_process_state(SimulationSystem* system, PCB* process, int state);
+int has_live_processes(const SimulationSystem* system);
+
 //Instruction/Process interaction
+PCB* allocate_process(SimulationSystem* system);
 PCB* create_new_process(SimulationSystem* system, int prog_id);
+void release_process(SimulationSystem* system, PCB* process);
 void move_process_to_ready(SimulationSystem* system, PCB* process);
 
 //Scheduling
 void schedule_next_process(SimulationSystem* system);
 
 //Output
+const char* state_name(int state);
 void print_current_state(SimulationSystem* system, int time);
+void print_state_row(FILE* out, int time, const char* cells);
 
 #endif
\ No newline at end of file
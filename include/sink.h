@@ -0,0 +1,30 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include "simulation.h"
+
+/*
+ * Output sink: receives every state transition (including creation, from
+ * NO_STATE, and reaping, to NO_STATE), the end of every tick and the end of
+ * the run. Any callback may be NULL.
+ */
+struct OutputSink {
+    void (*on_transition)(OutputSink* sink, const SimulationSystem* system, const PCB* process, int from, int to);
+    void (*on_tick)(OutputSink* sink, SimulationSystem* system);
+    void (*on_finish)(OutputSink* sink, SimulationSystem* system);
+    void* ctx;
+};
+
+// Default sink: the state table printed to stdout
+extern OutputSink table_output_sink;
+
+// Registration
+int simulation_add_sink(SimulationSystem* system, OutputSink* sink);
+void simulation_clear_sinks(SimulationSystem* system);
+
+// Dispatch (called from simulation.c)
+void sinks_transition(SimulationSystem* system, const PCB* process, int from, int to);
+void sinks_tick(SimulationSystem* system);
+void sinks_finish(SimulationSystem* system);
+
+#endif /* SINK_H */
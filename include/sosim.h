@@ -0,0 +1,40 @@
+#ifndef SOSIM_H
+#define SOSIM_H
+
+#include "simulation.h"
+#include "sink.h"
+#include "metrics.h"
+
+/*
+ * libsosim: the simulator engine as a library. A program links against
+ * libsosim.a or libsosim.so, creates a system from a SimulationInput,
+ * steps or runs it and reads results straight from the SimulationSystem
+ * (PCBs, queues, metrics) instead of parsing the text table.
+ *
+ * Systems made by sosim_create() start with no output at all: register
+ * observers (or any OutputSink, e.g. &table_output_sink) before the first
+ * step. Observers are called synchronously on every state transition with
+ * the PCB itself; the pointers are only valid during the call.
+ */
+#define SOSIM_VERSION SIM_ENGINE_VERSION
+
+// from is NO_STATE when the process is created, to is NO_STATE when it is reaped
+typedef void (*SimTransitionObserver)(void* ctx, const SimulationSystem* system,
+                                      const PCB* process, int from, int to);
+
+// Lifecycle (the system lives on the heap: SimulationSystem must not be copied)
+SimulationSystem* sosim_create(SimulationInput input);
+void sosim_destroy(SimulationSystem* system);
+
+// Stepping: one tick / ticks up to time (inclusive). Return 0 once every
+// process has exited or max_ticks is reached.
+int sosim_step(SimulationSystem* system);
+int sosim_run_until(SimulationSystem* system, int time);
+// Runs to the end (as the command line does) and notifies on_finish
+void sosim_run(SimulationSystem* system);
+
+// Observers are owned by the system and freed by sosim_destroy() (keep them
+// registered: simulation_clear_sinks() would leak them)
+OutputSink* sosim_add_observer(SimulationSystem* system, SimTransitionObserver observer, void* ctx);
+
+#endif /* SOSIM_H */
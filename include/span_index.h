@@ -0,0 +1,55 @@
+#ifndef SPAN_INDEX_H
+#define SPAN_INDEX_H
+
+#include "simulation.h"
+#include "sink.h"
+
+#define SPAN_INDEX_MAGIC 0x58495353u    // "SSIX"
+#define SPAN_INDEX_VERSION 1
+#define SPAN_INDEX_BLOCK 256            // Intervalos por bloco no ficheiro
+
+/*
+ * Interval index of the run: for every PID, the spans [start, end) during
+ * which it stayed in one state, as the table rows show it (a state held
+ * for zero ticks, e.g. READY between two quanta, does not appear).
+ *
+ * Spans are written in blocks of SPAN_INDEX_BLOCK per PID as they close,
+ * so memory use does not grow with the run; on close a directory of the
+ * blocks (offset, first start) and a trailer are appended. A reader loads
+ * only the directory and answers a point query with two binary searches
+ * and a single block read. A run restored from a checkpoint is indexed
+ * from the tick it resumes at: simulation_add_sink() reports every live
+ * process as a NO_STATE -> state transition at that tick, which opens its
+ * span, so restored processes are covered before their next transition.
+ *
+ * Layout: int32 magic, int32 version; blocks of (int32 start, end, state);
+ * per PID int32 block count and (int64 offset, int32 first start, int32
+ * count) per block; trailer int64 directory offset, int32 end time,
+ * int32 PID count, int32 magic.
+ */
+OutputSink* span_index_open(const char* path);
+// Returns 0 if the index could not be written completely
+int span_index_close(OutputSink* sink);
+
+// Queries
+typedef struct {
+    int start;
+    int end;                // Exclusivo
+    int state;
+} StateSpan;
+
+typedef struct SpanIndex SpanIndex;
+
+SpanIndex* span_index_load(const char* path);
+void span_index_free(SpanIndex* index);
+int span_index_end_time(const SpanIndex* index);
+int span_index_pid_count(const SpanIndex* index);
+
+// State shown for pid in the row of time, NO_STATE if it was not alive
+int span_index_state_at(SpanIndex* index, int pid, int time);
+// Spans of pid overlapping [from, to], in order (at most max); returns how many
+int span_index_spans(SpanIndex* index, int pid, int from, int to, StateSpan* spans, int max);
+// Whether pid was in state at some time in [from, to]
+int span_index_was_in_state(SpanIndex* index, int pid, int state, int from, int to);
+
+#endif /* SPAN_INDEX_H */
@@ -0,0 +1,70 @@
+#ifndef TRACEPOINT_H
+#define TRACEPOINT_H
+
+/*
+ * Static tracepoints for the simulator hot path.
+ *
+ * Built without SIM_TRACEPOINTS every SIM_TRACE() expands to nothing. With
+ * SIM_TRACEPOINTS each site checks a registered callback and, when
+ * <sys/sdt.h> is available, also emits a USDT probe (provider "sosim") that
+ * perf/bpftrace/systemtap can attach to.
+ */
+
+// Tracepoint ids (SIM_TRACE(name, ...) uses TP_##name)
+enum TRACEPOINTS {
+    TP_process_create,      // pid, program_id
+    TP_state_transition,    // pid, from, to
+    TP_schedule,            // pid escolhido, nº em READY antes do despacho
+    TP_quantum_expire,      // pid, pc
+    TP_exit_reap,           // pid, program_id
+    NUM_TRACEPOINTS
+};
+
+typedef struct {
+    int tracepoint;
+    int time;
+    int pid;
+    int arg0;
+    int arg1;
+} TraceRecord;
+
+typedef void (*TraceCallback)(const TraceRecord* record, void* ctx);
+
+#ifdef SIM_TRACEPOINTS
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define SIM_TRACE_USDT(name, time, pid, a0, a1) DTRACE_PROBE4(sosim, name, time, pid, a0, a1)
+#endif
+#endif
+#ifndef SIM_TRACE_USDT
+#define SIM_TRACE_USDT(name, time, pid, a0, a1) ((void)0)
+#endif
+
+typedef struct {
+    TraceCallback callback;
+    void* ctx;
+} TraceHandler;
+
+extern TraceHandler trace_handlers[NUM_TRACEPOINTS];
+
+void tracepoint_register(int tracepoint, TraceCallback callback, void* ctx);
+void tracepoint_unregister(int tracepoint);
+void tracepoint_fire(int tracepoint, int time, int pid, int arg0, int arg1);
+
+#define SIM_TRACE(name, time, pid, a0, a1)                                  \
+    do {                                                                    \
+        SIM_TRACE_USDT(name, time, pid, a0, a1);                            \
+        if (trace_handlers[TP_##name].callback) {                           \
+            tracepoint_fire(TP_##name, (time), (pid), (a0), (a1));          \
+        }                                                                   \
+    } while (0)
+
+#else
+
+#define SIM_TRACE(name, time, pid, a0, a1) ((void)0)
+
+#endif /* SIM_TRACEPOINTS */
+
+#endif /* TRACEPOINT_H */
@@ -0,0 +1,92 @@
+#include "include/incremental.h"
+#include "include/checkpoint.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+/**
+ * A checkpoint can be resumed from if it was taken at the expected tick and
+ * no process of a program that differs from the edited table exists yet.
+ */
+static int checkpoint_usable(const SimulationSystem* system, int time, int max_ticks,
+                             const int programs[5][MAX_INSTRUCTIONS], const int lengths[5]) {
+    if (system->current_time != time || system->max_ticks != max_ticks) return 0;
+
+    int changed[5];
+    for (int i = 0; i < 5; i++) {
+        changed[i] = system->program_lengths[i] != lengths[i] ||
+                     memcmp(system->programs[i], programs[i], sizeof(system->programs[i])) != 0;
+    }
+
+    // Todos os processos criados até aqui, incluindo os que já saíram
+    const SimulationMetrics* m = &system->metrics;
+    for (int slot = 0; slot < m->processes_created && slot < MAX_PROCESSES; slot++) {
+        int program_id = m->processes[slot].program_id;
+        if (program_id >= 0 && program_id < 5 && changed[program_id]) return 0;
+    }
+    return 1;
+}
+
+static int try_checkpoint(SimulationSystem* system, const char* pattern, int time, int max_ticks,
+                          const int programs[5][MAX_INSTRUCTIONS], const int lengths[5]) {
+    char path[512];
+    if (!checkpoint_path(path, sizeof(path), pattern, time) || !checkpoint_read_file(system, path)) return 0;
+
+    int usable = checkpoint_usable(system, time, max_ticks, programs, lengths);
+    cleanup_simulation(system);
+    return usable;
+}
+
+int incremental_resume(SimulationSystem* system, const int programs[5][MAX_INSTRUCTIONS],
+                       const int lengths[5], const char* pattern, int every, int max_ticks) {
+    if (every <= 0 || !checkpoint_pattern_valid(pattern)) return -1;
+
+    // Uma vez afetado, todos os checkpoints seguintes também o são:
+    // pesquisa binária pelo último utilizável
+    int lo = 0;
+    int hi = max_ticks / every;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (try_checkpoint(system, pattern, mid * every, max_ticks, programs, lengths)) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    if (lo == 0) return -1;
+
+    char path[512];
+    if (!checkpoint_path(path, sizeof(path), pattern, lo * every) || !checkpoint_read_file(system, path)) {
+        return -1;
+    }
+
+    // Os processos já criados mantêm a sua cópia do programa antigo (igual)
+    memcpy(system->programs, programs, sizeof(system->programs));
+    memcpy(system->program_lengths, lengths, sizeof(system->program_lengths));
+    return lo * every;
+}
+
+int incremental_reuse_prefix(FILE* file, int ticks) {
+    long offset = 0;
+    int lines = 0;
+    int c;
+
+    // Cabeçalho + uma linha por tick
+    rewind(file);
+    while (lines < ticks + 1 && (c = fgetc(file)) != EOF) {
+        offset++;
+        if (c == '\n') lines++;
+    }
+    if (lines < ticks + 1) return 0;
+
+    fflush(file);
+#ifndef _WIN32
+    if (ftruncate(fileno(file), (off_t)offset) != 0) return 0;
+#else
+    if (_chsize(_fileno(file), offset) != 0) return 0;
+#endif
+    return fseek(file, offset, SEEK_SET) == 0;
+}
@@ -53,3 +53,7 @@ int input05[11][20] = {
     {    0,    0,    0, -253,  -19,    0,    0, -318,    0,  347,    0,    0,   87,    0,    0,    0,    0,    0,    0, -257 },
     {    0,    0,    0,  628,  326,    0,    0,    0,    0,  420,    0,    0,  393,    0,    0,    0,    0,    0,    0,   -4 },
     {    0,    0,    0, -101,  -46,    0,    0,    0,    0, -319,    0,    0,  534,    0,    0,    0,    0,    0,    0, -175 }};
+
+SimulationInput simulation_inputs[NUM_INPUTS] = {
+    {input00, 5}, {input01, 5}, {input02, 4}, {input03, 5}, {input04, 11}, {input05, 11}
+};
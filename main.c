@@ -3,45 +3,760 @@
 #include <stdlib.h>
 #include "include/inputs.h"
 #include "include/simulation.h"
+#include "include/metrics.h"
+#include "include/chrome_trace.h"
+#include "include/harness.h"
+#include "include/realtime.h"
+#include "include/shm_ring.h"
+#include "include/checkpoint.h"
+#include "include/replay.h"
+#include "include/incremental.h"
+#include "include/result_cache.h"
+#include "include/cycle.h"
+#include "include/analysis.h"
+#include "include/span_index.h"
+#include "include/columnar.h"
+#include "include/async_writer.h"
+#include "include/histogram.h"
+#include "include/profile.h"
 
-int main() {
-    SimulationInput inputs[NUM_INPUTS] = {
-            {input00, 5}, {input01, 5}, {input02, 4}, {input03, 5}, {input04, 11}, {input05, 11}
-    };
+#define DEFAULT_SOCKET_PATH "/tmp/sosim.sock"
 
-    for (int i = 0; i < NUM_INPUTS; i++) {
-        SimulationSystem system;
-        char filename[20];
-        snprintf(filename, sizeof(filename), "output%02d.out", i);
+typedef struct {
+    int chrome_trace;       // --chrome-trace: também escreve outputNN.json
+    int max_ticks;          // --ticks (0 = por omissão; sem limite em tempo real)
+    double realtime_hz;     // --realtime: ticks por segundo (0 = o mais rápido possível)
+    const char* socket_path;
+    const char* shm_ring_path; // --shm-ring: publica as transições em memória partilhada
+    const char* arrivals_path; // --arrivals: trace de chegadas "<tempo> <programa>"
+    int device_channels[MAX_DEVICES]; // --device D:C (-1 = não configurado)
+    int checkpoint_every;   // --checkpoint-every: grava o estado a cada N ticks
+    const char* checkpoint_path; // --checkpoint-path: padrão com um %d para o tick
+    const char* restore_path;    // --restore: continua a partir de um checkpoint
+    const char* replay_log_path; // --replay-log: grava entradas, decisões e keyframes
+    int keyframe_every;          // --keyframe-every: intervalo entre keyframes
+    int incremental;             // --incremental: retoma dos checkpoints da execução anterior
+    int program_counts[5];       // --program ID:I,I,...: substitui um programa (-1 = não)
+    int programs[5][MAX_INSTRUCTIONS];
+    const char* cache_dir;       // --cache: reaproveita resultados de execuções iguais
+    int cache_mb;                // --cache-size: limite do diretório em MiB
+    int fast_forward;            // --fast-forward: salta períodos de estados cíclicos
+    int skip_ahead;              // --skip-ahead: executa em bloco os ticks sem eventos
+    int analyze;                 // --analyze: relatório da análise estática dos programas
+    int span_index;              // --span-index: também escreve outputNN.idx
+    int columnar;                // --columnar: também escreve outputNN.col
+    int async_output;            // --async-output: outputNN.out escrito por uma thread
+    int histogram;               // --histogram: contagens por estado em vez da tabela
+    int per_program;             // --per-program: as contagens do histograma por programa
+    int profile_every;           // --profile: tempo de cada fase, 1 em cada N ticks (0 = desligado)
+} RunOptions;
+
+static void usage(const char* program) {
+    fprintf(stderr, "Usage: %s [--input N] [--ticks N] [--chrome-trace] [--shm-ring PATH]\n"
+                    "       [--arrivals FILE] [--device ID:CHANNELS]... [--check GOLDEN_DIR]\n"
+                    "       [--checkpoint-every N [--checkpoint-path PATTERN]] [--restore FILE]\n"
+                    "       [--replay-log FILE [--keyframe-every N]] [--program ID:I,I,...]...\n"
+                    "       [--incremental --checkpoint-every N [--checkpoint-path PATTERN]]\n"
+                    "       [--cache DIR [--cache-size MB]] [--fast-forward] [--skip-ahead]\n"
+                    "       [--analyze] [--span-index] [--columnar]\n"
+                    "       [--async-output] [--histogram [--per-program]]\n"
+                    "       [--profile [--profile-every N]]\n", program);
+    fprintf(stderr, "       %s --replay FILE --seek T [--ticks N]\n", program);
+    fprintf(stderr, "       %s --query FILE [--pid P] (--at T | --from T1 --to T2 [--state S])\n", program);
+    fprintf(stderr, "       %s --read-column FILE --pid P\n", program);
+    fprintf(stderr, "       %s --shm-read PATH\n", program);
+    fprintf(stderr, "       %s --realtime HZ [--socket PATH] [--input N] [--ticks N]\n", program);
+    fprintf(stderr, "       %s --bench [--baseline FILE] [--threshold PCT] [--update-baseline] [--perf]\n", program);
+}
+
+/* Seeks a replay log to time and prints the next ticks (0 = until the end) */
+static int run_replay(const char* path, int time, int ticks) {
+    ReplayReader* reader = replay_open(path);
+    if (!reader) {
+        fprintf(stderr, "Error opening replay log %s\n", path);
+        return 1;
+    }
+
+    SimulationSystem system;
+    int keyframe = replay_seek(reader, &system, time);
+    if (keyframe < 0) {
+        fprintf(stderr, "No keyframe at or before tick %d\n", time);
+        replay_close(reader);
+        return 1;
+    }
+    fprintf(stderr, "replay: keyframe %d, replayed %d ticks to %d\n",
+            keyframe, system.current_time - keyframe, system.current_time);
+
+    simulation_add_sink(&system, &table_output_sink);
+    int end = system.current_time + ticks;
+    while ((ticks <= 0 || system.current_time < end) && replay_step(reader, &system)) {
+    }
+
+    fprintf(stderr, "replay: stopped at %d, %ld divergences\n",
+            system.current_time, replay_divergences(reader));
+    int diverged = replay_divergences(reader) > 0;
+    cleanup_simulation(&system);
+    replay_close(reader);
+    return diverged;
+}
+
+/* Answers a query on a span index: state at a time, or spans/PIDs in a range */
+static int run_query(const char* path, int pid, int state, int from, int to) {
+    SpanIndex* index = span_index_load(path);
+    if (!index) {
+        fprintf(stderr, "Error opening span index %s\n", path);
+        return 1;
+    }
+
+    int first = pid > 0 ? pid : 1;
+    int last = pid > 0 ? pid : span_index_pid_count(index);
+    for (int p = first; p <= last; p++) {
+        if (to < 0) {
+            // Instante: o estado na linha de from
+            int at = span_index_state_at(index, p, from);
+            if (at != NO_STATE || pid > 0) printf("%d\t%d\t%s\n", from, p, at != NO_STATE ? state_name(at) : "-");
+        } else if (state != NO_STATE) {
+            if (span_index_was_in_state(index, p, state, from, to)) printf("%d\n", p);
+        } else {
+            StateSpan spans[SPAN_INDEX_BLOCK];
+            int offset = from;
+            int found;
+            do {
+                found = span_index_spans(index, p, offset, to, spans, SPAN_INDEX_BLOCK);
+                for (int i = 0; i < found; i++) {
+                    printf("%d\t%d\t%d\t%s\n", p, spans[i].start, spans[i].end, state_name(spans[i].state));
+                }
+                if (found > 0) offset = spans[found - 1].end;
+            } while (found == SPAN_INDEX_BLOCK && offset <= to);
+        }
+    }
+
+    span_index_free(index);
+    return 0;
+}
+
+/* Follows a --shm-ring ring and prints its transitions until the run ends */
+static int run_shm_read(const char* path) {
+    ShmRingReader* reader = shm_ring_attach(path);
+    if (!reader) {
+        fprintf(stderr, "Error attaching to ring %s\n", path);
+        return 1;
+    }
 
-        FILE* output_file = freopen(filename, "w", stdout);
-        if (output_file == NULL) {
-            perror("Error opening output file");
-            continue;  // Skip this input if file fails
+    ShmRecord record;
+    long records = 0, lost = 0;
+    while (1) {
+        long result = shm_ring_read_wait(reader, &record, 1000);
+        if (result == 0) continue;      // Produtor parado: continua à espera
+        if (result < 0) {
+            // Ficou para trás: esses registos já foram reescritos
+            fprintf(stderr, "shm-read: lost %ld records\n", -result);
+            lost -= result;
+            continue;
+        }
+        records++;
+        if (record.type == SHM_RECORD_END) break;
+        if (record.type == SHM_RECORD_TRANSITION) {
+            printf("%d\t%d\t%s\t%s\t%d\n", record.time, record.pid,
+                   record.from == NO_STATE ? "-" : state_name(record.from),
+                   record.to == NO_STATE ? "-" : state_name(record.to), record.program_id);
+        }
+    }
+    fprintf(stderr, "shm-read: %ld records, %ld lost\n", records, lost);
+    shm_ring_detach(reader);
+    return 0;
+}
+
+/* Prints the rows of one PID's column of a columnar output */
+static int run_read_column(const char* path, int pid) {
+    ColumnarReader* reader = columnar_reader_open(path);
+    if (!reader) {
+        fprintf(stderr, "Error opening columnar output %s\n", path);
+        return 1;
+    }
+
+    long rows = columnar_rows(reader);
+    unsigned char* codes = (unsigned char*)malloc(rows > 0 ? rows : 1);
+    long decoded = codes ? columnar_read_column(reader, pid, codes, rows) : -1;
+    if (decoded < 0) {
+        fprintf(stderr, "Error reading column %d of %s\n", pid, path);
+    }
+    for (long i = 0; i < decoded; i++) {
+        if (codes[i] != 0) {
+            printf("%ld\t%s\n", columnar_first_time(reader) + i, columnar_code_name(reader, codes[i]));
+        }
+    }
+
+    free(codes);
+    columnar_reader_close(reader);
+    return decoded < 0;
+}
+
+static void checkpoint_pattern(char* pattern, size_t size, int index, const RunOptions* options) {
+    if (options->checkpoint_path) {
+        snprintf(pattern, size, "%s", options->checkpoint_path);
+    } else {
+        snprintf(pattern, size, "output%02d-%%06d.ckpt", index);
+    }
+}
+
+/* Initializes one input with the --program edits applied */
+static void prepare_system(SimulationSystem* system, int index, const RunOptions* options) {
+    SimulationInput input = simulation_inputs[index];
+    int programs[5][20];
+
+    // As edições entram antes de o primeiro processo copiar o programa 0
+    for (int i = 0; i < input.rows && i < 5; i++) {
+        if (options->program_counts[i] >= 0) {
+            for (int j = 0; j < 20; j++) {
+                programs[i][j] = j < options->program_counts[i] ? options->programs[i][j] : 0;
+            }
+        } else {
+            memcpy(programs[i], input.programs[i], sizeof(programs[i]));
+        }
+    }
+    input.programs = programs;
+    initialize_system_with_input(system, input);
+
+    for (int i = input.rows; i < 5; i++) {
+        if (options->program_counts[i] >= 0) {
+            set_program(system, i, options->programs[i], options->program_counts[i]);
+        }
+    }
+    if (options->max_ticks > 0) {
+        system->max_ticks = options->max_ticks;
+    }
+}
+
+static void configure_devices(SimulationSystem* system, const RunOptions* options) {
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        if (options->device_channels[d] >= 0) {
+            io_configure_device(&system->io, d, options->device_channels[d]);
+        }
+    }
+}
+
+/*
+ * Only plain runs are cached: the key covers the workload, not extra
+ * outputs or inputs, and a hit skips the --analyze and --profile reports.
+ */
+static int cacheable(const RunOptions* options) {
+    return options->cache_dir && !options->chrome_trace && !options->shm_ring_path &&
+           !options->arrivals_path && options->realtime_hz <= 0 && !options->restore_path &&
+           !options->incremental && !options->replay_log_path && options->checkpoint_every <= 0 &&
+           !options->span_index && !options->columnar && !options->histogram &&
+           !options->analyze && options->profile_every <= 0;
+}
+
+/* Restores the previous run's latest checkpoint unaffected by the edits */
+static int resume_input(SimulationSystem* system, int index, const RunOptions* options) {
+    SimulationSystem edited;
+    char pattern[256];
+
+    prepare_system(&edited, index, options);
+    checkpoint_pattern(pattern, sizeof(pattern), index, options);
+    int resumed_at = incremental_resume(system, (const int (*)[MAX_INSTRUCTIONS])edited.programs,
+                                        edited.program_lengths, pattern,
+                                        options->checkpoint_every, edited.max_ticks);
+    cleanup_simulation(&edited);
+    return resumed_at;
+}
+
+/**
+ * Runs one input and writes outputNN.out, outputNN.stats (and outputNN.json).
+ * Returns 0, 1 if its files fail or 2 if the result came from the cache.
+ */
+static int run_input(int index, const RunOptions* options) {
+    SimulationSystem system;
+    char filename[20], stats_filename[20];
+    snprintf(filename, sizeof(filename), "output%02d.out", index);
+    snprintf(stats_filename, sizeof(stats_filename), "output%02d.stats", index);
+
+    ResultCacheKey cache_key;
+    if (cacheable(options)) {
+        prepare_system(&system, index, options);
+        configure_devices(&system, options);
+        result_cache_key(&system, &cache_key);
+        cleanup_simulation(&system);
+
+        if (result_cache_lookup(options->cache_dir, &cache_key, filename, stats_filename)) {
+            fprintf(stderr, "cache: output%02d hit\n", index);
+            return 2;
+        }
+    }
+
+    // --incremental: o prefixo de outputNN.out até ao checkpoint fica como está
+    int resumed_at = -1;
+    FILE* output_file = NULL;
+    if (options->incremental && !options->restore_path) {
+        resumed_at = resume_input(&system, index, options);
+    }
+    if (resumed_at > 0) {
+        output_file = fopen(filename, "r+");
+        if (!output_file || !incremental_reuse_prefix(output_file, resumed_at)) {
+            if (output_file) fclose(output_file);
+            output_file = NULL;
+            cleanup_simulation(&system);
+            resumed_at = -1;
+        }
+    }
+    AsyncWriterStats writer_stats;
+    int async_output = options->async_output && !output_file;
+    if (async_output) {
+        output_file = async_writer_open(filename, ASYNC_WRITER_DEFAULT_BUFFER, &writer_stats);
+    }
+    if (!output_file) {
+        async_output = 0;
+        output_file = fopen(filename, "w");
+    }
+    if (output_file == NULL) {
+        perror("Error opening output file");
+        if (resumed_at > 0) cleanup_simulation(&system);
+        return 1;
+    }
+
+    if (resumed_at > 0) {
+        fprintf(stderr, "incremental: output%02d resumed at tick %d\n", index, resumed_at);
+    } else if (options->restore_path) {
+        if (!checkpoint_read_file(&system, options->restore_path)) {
+            fprintf(stderr, "Error restoring %s\n", options->restore_path);
+            fclose(output_file);
+            return 1;
+        }
+    } else {
+        prepare_system(&system, index, options);
+    }
+    system.output = output_file;
+    system.skip_ahead = options->skip_ahead;
+    if (options->max_ticks > 0) {
+        system.max_ticks = options->max_ticks;
+    }
+    configure_devices(&system, options);
+
+    if (options->analyze) {
+        WorkloadAnalysis analysis;
+        analyze_workload(&system, &analysis);
+        fprintf(stderr, "analysis: output%02d\n", index);
+        print_workload_analysis(&analysis, stderr);
+    }
+
+    // As contagens substituem a tabela em outputNN.out
+    OutputSink* histogram_sink = NULL;
+    if (options->histogram) {
+        histogram_sink = histogram_open(output_file, options->per_program);
+        if (histogram_sink) {
+            simulation_clear_sinks(&system);
+            simulation_add_sink(&system, histogram_sink);
+        }
+    }
+
+    OutputSink* trace_sink = NULL;
+    if (options->chrome_trace) {
+        char trace_filename[20];
+        snprintf(trace_filename, sizeof(trace_filename), "output%02d.json", index);
+        trace_sink = chrome_trace_open(trace_filename);
+        if (!trace_sink) {
+            fprintf(stderr, "Error opening %s\n", trace_filename);
+        } else {
+            simulation_add_sink(&system, trace_sink);
+        }
+    }
+
+    OutputSink* span_sink = NULL;
+    if (options->span_index) {
+        char index_filename[20];
+        snprintf(index_filename, sizeof(index_filename), "output%02d.idx", index);
+        span_sink = span_index_open(index_filename);
+        if (!span_sink) {
+            fprintf(stderr, "Error opening %s\n", index_filename);
+        } else {
+            simulation_add_sink(&system, span_sink);
+        }
+    }
+
+    OutputSink* columnar_sink = NULL;
+    if (options->columnar) {
+        char columnar_filename[20];
+        snprintf(columnar_filename, sizeof(columnar_filename), "output%02d.col", index);
+        columnar_sink = columnar_open(columnar_filename);
+        if (!columnar_sink) {
+            fprintf(stderr, "Error opening %s\n", columnar_filename);
+        } else {
+            simulation_add_sink(&system, columnar_sink);
+        }
+    }
+
+    ArrivalStream* arrivals = NULL;
+    if (options->arrivals_path) {
+        arrivals = arrivals_open(options->arrivals_path);
+        if (!arrivals) {
+            fprintf(stderr, "Error opening %s\n", options->arrivals_path);
+        }
+        system.arrivals = arrivals;
+    }
+
+    OutputSink* ring_sink = NULL;
+    if (options->shm_ring_path) {
+        ring_sink = shm_ring_open(options->shm_ring_path, SHM_RING_DEFAULT_CAPACITY);
+        if (!ring_sink) {
+            fprintf(stderr, "Error opening %s\n", options->shm_ring_path);
+        } else {
+            simulation_add_sink(&system, ring_sink);
+        }
+    }
+
+    OutputSink* checkpoint_sink = NULL;
+    if (options->checkpoint_every > 0) {
+        char pattern[256];
+        checkpoint_pattern(pattern, sizeof(pattern), index, options);
+        checkpoint_sink = checkpoint_sink_open(options->checkpoint_every, pattern);
+        if (!checkpoint_sink) {
+            fprintf(stderr, "Invalid checkpoint pattern: %s\n", pattern);
+        } else {
+            simulation_add_sink(&system, checkpoint_sink);
+        }
+    }
+
+    ReplayLog* replay_log = NULL;
+    if (options->replay_log_path) {
+        replay_log = replay_log_open(options->replay_log_path, options->keyframe_every);
+        if (!replay_log || !replay_log_attach(replay_log, &system)) {
+            fprintf(stderr, "Error opening %s\n", options->replay_log_path);
+        }
+    }
+
+    if (options->realtime_hz > 0) {
+        RealtimeConfig config = {options->realtime_hz, options->socket_path, options->max_ticks};
+        RealtimeStats stats;
+        if (run_realtime(&system, &config, &stats) == 0) {
+            fprintf(stderr, "realtime: %d ticks, %d late, %ld commands\n",
+                    stats.ticks, stats.late_ticks, stats.commands);
+        }
+    } else {
+        CycleDetector* detector = NULL;
+        if (options->fast_forward) {
+            detector = (CycleDetector*)malloc(sizeof(CycleDetector));
+            if (detector) {
+                cycle_detector_init(detector);
+                system.cycle_detector = detector;
+            }
+        }
+
+        PhaseProfiler* profiler = NULL;
+        if (options->profile_every > 0) {
+            profiler = (PhaseProfiler*)malloc(sizeof(PhaseProfiler));
+            if (profiler) {
+                phase_profiler_init(profiler, options->profile_every);
+                system.profiler = profiler;
+            }
         }
 
-        initialize_system_with_input(&system, inputs[i]);
         run_simulation(&system);
 
-        // Cleanup processes safely
-        for (int j = 0; j < 20; j++) {
-            if (system.processes[j] != NULL) {
-                if (system.processes[j]->instructions) {
-                    free(system.processes[j]->instructions);
-                }
-                free(system.processes[j]);
-                system.processes[j] = NULL;  // Prevent double-free
+        if (profiler) {
+            fprintf(stderr, "profile: output%02d\n", index);
+            phase_profiler_print(profiler, stderr);
+            system.profiler = NULL;
+            free(profiler);
+        }
+        if (detector) {
+            if (detector->skipped_ticks > 0) {
+                fprintf(stderr, "fast-forward: output%02d skipped %ld ticks (period %d)\n",
+                        index, detector->skipped_ticks, detector->period);
             }
+            system.cycle_detector = NULL;
+            cycle_detector_free(detector);
+            free(detector);
+        }
+    }
+    chrome_trace_close(trace_sink);
+    histogram_close(histogram_sink);
+    if (!span_index_close(span_sink)) {
+        fprintf(stderr, "Error writing output%02d.idx\n", index);
+    }
+    if (!columnar_close(columnar_sink)) {
+        fprintf(stderr, "Error writing output%02d.col\n", index);
+    }
+    shm_ring_close(ring_sink);
+    checkpoint_sink_close(checkpoint_sink);
+    replay_log_close(replay_log, &system);
+    if (arrivals) {
+        fprintf(stderr, "arrivals: %ld admitted, %ld rejected, %ld out of order\n",
+                arrivals->admitted, arrivals->rejected, arrivals->out_of_order);
+        arrivals_close(arrivals);
+    }
+
+    // Per-run scheduling summary
+    FILE* stats_file = fopen(stats_filename, "w");
+    if (stats_file) {
+        print_simulation_summary(&system, stats_file);
+        fclose(stats_file);
+    }
+
+    cleanup_simulation(&system);
+
+    if (fclose(output_file) != 0) {
+        fprintf(stderr, "Error writing %s\n", filename);
+    }
+    if (async_output) {
+        fprintf(stderr, "async-output: output%02d %llu bytes in %ld writes (%s), %ld stalls (%.1f ms)\n",
+                index, (unsigned long long)writer_stats.bytes, writer_stats.buffers, writer_stats.backend,
+                writer_stats.stalls, writer_stats.stall_ns / 1e6);
+    }
+    if (cacheable(options) &&
+        !result_cache_store(options->cache_dir, (long)options->cache_mb * 1024 * 1024,
+                            &cache_key, filename, stats_filename)) {
+        fprintf(stderr, "cache: could not store output%02d\n", index);
+    }
+    return 0;
+}
+
+/* Options that configure the runs; returns 1 if argv[*i] was one (and consumes its value) */
+static int parse_run_option(int argc, char** argv, int* i, RunOptions* options) {
+    int device, channels, prog_id, offset = 0;
+
+    if (strcmp(argv[*i], "--chrome-trace") == 0) {
+        options->chrome_trace = 1;
+    } else if (strcmp(argv[*i], "--ticks") == 0 && *i + 1 < argc) {
+        options->max_ticks = atoi(argv[++*i]);
+    } else if (strcmp(argv[*i], "--realtime") == 0 && *i + 1 < argc) {
+        options->realtime_hz = atof(argv[++*i]);
+    } else if (strcmp(argv[*i], "--socket") == 0 && *i + 1 < argc) {
+        options->socket_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--shm-ring") == 0 && *i + 1 < argc) {
+        options->shm_ring_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--arrivals") == 0 && *i + 1 < argc) {
+        options->arrivals_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--device") == 0 && *i + 1 < argc &&
+               sscanf(argv[*i + 1], "%d:%d", &device, &channels) == 2 &&
+               device >= 0 && device < MAX_DEVICES && channels >= 0) {
+        options->device_channels[device] = channels;
+        (*i)++;
+    } else if (strcmp(argv[*i], "--checkpoint-every") == 0 && *i + 1 < argc) {
+        options->checkpoint_every = atoi(argv[++*i]);
+    } else if (strcmp(argv[*i], "--checkpoint-path") == 0 && *i + 1 < argc) {
+        options->checkpoint_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--restore") == 0 && *i + 1 < argc) {
+        options->restore_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--replay-log") == 0 && *i + 1 < argc) {
+        options->replay_log_path = argv[++*i];
+    } else if (strcmp(argv[*i], "--keyframe-every") == 0 && *i + 1 < argc) {
+        options->keyframe_every = atoi(argv[++*i]);
+    } else if (strcmp(argv[*i], "--incremental") == 0) {
+        options->incremental = 1;
+    } else if (strcmp(argv[*i], "--program") == 0 && *i + 1 < argc &&
+               sscanf(argv[*i + 1], "%d:%n", &prog_id, &offset) == 1 && offset > 0 && prog_id >= 0 && prog_id < 5) {
+        int count = 0;
+        for (char* arg = strtok(argv[++*i] + offset, ","); arg && count < MAX_INSTRUCTIONS;
+             arg = strtok(NULL, ",")) {
+            options->programs[prog_id][count++] = atoi(arg);
+        }
+        options->program_counts[prog_id] = count;
+    } else if (strcmp(argv[*i], "--cache") == 0 && *i + 1 < argc) {
+        options->cache_dir = argv[++*i];
+    } else if (strcmp(argv[*i], "--cache-size") == 0 && *i + 1 < argc) {
+        options->cache_mb = atoi(argv[++*i]);
+    } else if (strcmp(argv[*i], "--fast-forward") == 0) {
+        options->fast_forward = 1;
+    } else if (strcmp(argv[*i], "--skip-ahead") == 0) {
+        options->skip_ahead = 1;
+    } else if (strcmp(argv[*i], "--analyze") == 0) {
+        options->analyze = 1;
+    } else if (strcmp(argv[*i], "--span-index") == 0) {
+        options->span_index = 1;
+    } else if (strcmp(argv[*i], "--profile") == 0) {
+        if (options->profile_every == 0) options->profile_every = 1;
+    } else if (strcmp(argv[*i], "--profile-every") == 0 && *i + 1 < argc) {
+        options->profile_every = atoi(argv[++*i]);
+    } else if (strcmp(argv[*i], "--histogram") == 0) {
+        options->histogram = 1;
+    } else if (strcmp(argv[*i], "--per-program") == 0) {
+        options->per_program = 1;
+    } else if (strcmp(argv[*i], "--async-output") == 0) {
+        options->async_output = 1;
+    } else if (strcmp(argv[*i], "--columnar") == 0) {
+        options->columnar = 1;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+static int valid_options(const RunOptions* options) {
+    if (options->checkpoint_path && !checkpoint_pattern_valid(options->checkpoint_path)) {
+        fprintf(stderr, "Invalid checkpoint pattern: %s (use one %%d or %%0Nd for the tick)\n",
+                options->checkpoint_path);
+        return 0;
+    }
+    if (options->per_program && !options->histogram) {
+        fprintf(stderr, "--per-program needs --histogram\n");
+        return 0;
+    }
+    // The incremental run only reuses the table prefix; these outputs would be left partial
+    if (options->incremental && (options->checkpoint_every <= 0 || options->arrivals_path || options->histogram ||
+                                 options->chrome_trace || options->span_index || options->columnar)) {
+        fprintf(stderr, "--incremental needs --checkpoint-every and no --arrivals, --histogram, "
+                        "--chrome-trace, --span-index or --columnar\n");
+        return 0;
+    }
+    return 1;
+}
+
+/* Runs every input (or only `input`); returns how many were simulated rather than read from the cache */
+static int run_inputs(int input, const RunOptions* options) {
+    int simulated = 0;
+    for (int i = 0; i < NUM_INPUTS; i++) {
+        if (input >= 0 && i != input) continue;
+        if (run_input(i, options) == 0) simulated++;  // Skip this input if its files fail
+    }
+    return simulated;
+}
+
+/* --check: the command line's options plus those of one harness mode */
+typedef struct {
+    const RunOptions* options;
+    int input;
+} CheckContext;
+
+static int run_check_mode(char** args, int trace, void* ctx) {
+    const CheckContext* check = (const CheckContext*)ctx;
+    RunOptions options = *check->options;
+    int argc = 0;
+    while (args[argc]) argc++;
+
+    for (int i = 0; i < argc; i++) {
+        if (!parse_run_option(argc, args, &i, &options)) {
+            fprintf(stderr, "Unknown option: %s\n", args[i]);
+            return -1;
         }
+    }
+    // The golden files include the trace; the result cache only stores plain runs
+    options.chrome_trace = trace;
+    if (!valid_options(&options)) {
+        return -1;
+    }
+    return run_inputs(check->input, &options);
+}
+
+int main(int argc, char** argv) {
+    RunOptions options = {.socket_path = DEFAULT_SOCKET_PATH, .cache_mb = RESULT_CACHE_DEFAULT_MB};
+    const char* replay_path = NULL;  // --replay: lê um replay log em vez de simular
+    int seek = 0;
+    const char* query_path = NULL;  // --query: consulta um span index
+    int query_pid = 0;
+    int query_state = NO_STATE;
+    int query_from = -1;
+    int query_to = -1;
+    const char* column_path = NULL; // --read-column: lê uma coluna de um outputNN.col
+    const char* ring_path = NULL;   // --shm-read: segue o anel de uma execução com --shm-ring
+    int input = -1;                 // --input: só corre um dos inputs
+    const char* golden_dir = NULL;  // --check: compara as saídas com as de referência
+    int bench = 0;
+    int perf = 0;                   // --perf: contadores de hardware por workload
+    const char* baseline = NULL;
+    double threshold = HARNESS_DEFAULT_THRESHOLD;
+    int update_baseline = 0;
 
-        // Cleanup queues safely
-        if (system.new_queue) deleteQueue(system.new_queue);
-        if (system.ready_queue) deleteQueue(system.ready_queue);
-        if (system.blocked_queue) deleteQueue(system.blocked_queue);
-        if (system.exit_queue) deleteQueue(system.exit_queue);
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        options.device_channels[d] = -1;
+    }
+    for (int p = 0; p < 5; p++) {
+        options.program_counts[p] = -1;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (parse_run_option(argc, argv, &i, &options)) continue;
 
-        fclose(stdout);
+        if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            input = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--seek") == 0 && i + 1 < argc) {
+            seek = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--read-column") == 0 && i + 1 < argc) {
+            column_path = argv[++i];
+        } else if (strcmp(argv[i], "--shm-read") == 0 && i + 1 < argc) {
+            ring_path = argv[++i];
+        } else if (strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            query_path = argv[++i];
+        } else if (strcmp(argv[i], "--pid") == 0 && i + 1 < argc) {
+            query_pid = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+            query_from = atoi(argv[++i]);
+            query_to = -1;
+        } else if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            query_from = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            query_to = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--state") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            for (int s = 0; s < NUM_STATES; s++) {
+                if (strcmp(name, state_name(s)) == 0) query_state = s;
+            }
+            if (query_state == NO_STATE) {
+                fprintf(stderr, "Unknown state: %s\n", name);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc) {
+            golden_dir = argv[++i];
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            bench = 1;
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            perf = 1;
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--update-baseline") == 0) {
+            update_baseline = 1;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench || perf) {
+        int regressions = bench ? harness_benchmark(baseline, threshold, update_baseline) : 0;
+        int failed = perf ? harness_perf_counters() : 0;
+        return regressions || failed ? 1 : 0;
+    }
+    if (replay_path) {
+        return run_replay(replay_path, seek, options.max_ticks);
+    }
+    if (query_path) {
+        if (query_from < 0 || (query_state != NO_STATE && query_to < query_from)) {
+            usage(argv[0]);
+            return 1;
+        }
+        return run_query(query_path, query_pid, query_state, query_from, query_to);
+    }
+    if (ring_path) {
+        return run_shm_read(ring_path);
+    }
+    if (column_path) {
+        if (query_pid <= 0) {
+            usage(argv[0]);
+            return 1;
+        }
+        return run_read_column(column_path, query_pid);
+    }
+    if (!valid_options(&options)) {
+        return 1;
+    }
+    if (input >= NUM_INPUTS) {
+        fprintf(stderr, "Invalid input: %d\n", input);
+        return 1;
+    }
+    // Real-time mode and --restore drive a single simulation
+    if ((options.realtime_hz > 0 || options.restore_path) && input < 0) {
+        input = 0;
     }
 
+    if (golden_dir) {
+        CheckContext check = {&options, input};
+        return harness_check_outputs(golden_dir, run_check_mode, &check) ? 1 : 0;
+    }
+    run_inputs(input, &options);
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,104 @@
+#include "include/metrics.h"
+
+/* Incremental bookkeeping */
+void metrics_process_created(SimulationSystem* system, const PCB* process) {
+    int slot = process->pid - 1;
+    if (slot < 0 || slot >= MAX_PROCESSES) return;
+
+    ProcessMetrics* pm = &system->metrics.processes[slot];
+    memset(pm, 0, sizeof(ProcessMetrics));
+    pm->program_id = process->program_id;
+    pm->arrival_time = system->current_time;
+    pm->first_run_time = -1;
+    pm->finish_time = -1;
+    pm->state_since = system->current_time;
+
+    system->metrics.processes_created++;
+}
+
+void metrics_transition(SimulationSystem* system, const PCB* process, int from, int to) {
+    int slot = process->pid - 1;
+    if (slot < 0 || slot >= MAX_PROCESSES) return;
+
+    SimulationMetrics* m = &system->metrics;
+    ProcessMetrics* pm = &m->processes[slot];
+    int now = system->current_time;
+
+    pm->ticks_in_state[from] += now - pm->state_since;
+    pm->state_since = now;
+
+    if (to == RUNNING) {
+        pm->dispatches++;
+        m->context_switches++;
+        if (pm->first_run_time < 0) {
+            pm->first_run_time = now;
+            m->total_response += now - pm->arrival_time;
+            m->responded++;
+        }
+    } else if (to == EXIT) {
+        pm->finish_time = now;
+        m->processes_finished++;
+        m->total_turnaround += now - pm->arrival_time;
+        m->total_waiting += pm->ticks_in_state[READY];
+    }
+}
+
+void metrics_tick(SimulationSystem* system) {
+    system->metrics.ticks++;
+    if (system->state_counts[RUNNING] > 0) {
+        system->metrics.busy_ticks++;
+    }
+}
+
+/* Summary */
+static double average(long total, int count) {
+    return count > 0 ? (double)total / count : 0.0;
+}
+
+void print_simulation_summary(const SimulationSystem* system, FILE* out) {
+    if (!system || !out) return;
+
+    const SimulationMetrics* m = &system->metrics;
+    int now = system->current_time;
+
+    fprintf(out, "pid\tprog\tarrival\tfirst\tfinish\tturnaround\twaiting\tresponse\tblocked\tdispatches\n");
+    for (int slot = 0; slot < m->processes_created && slot < MAX_PROCESSES; slot++) {
+        const ProcessMetrics* pm = &m->processes[slot];
+        int ticks[NUM_STATES];
+
+        // Processos ainda vivos contam o tempo parcial no estado atual
+        memcpy(ticks, pm->ticks_in_state, sizeof(ticks));
+        if (pm->finish_time < 0 && system->processes[slot]) {
+            ticks[system->processes[slot]->state] += now - pm->state_since;
+        }
+
+        fprintf(out, "%d\t%d\t%d\t", slot + 1, pm->program_id, pm->arrival_time);
+        if (pm->first_run_time >= 0) fprintf(out, "%d\t", pm->first_run_time);
+        else fprintf(out, "-\t");
+        if (pm->finish_time >= 0) fprintf(out, "%d\t%d\t", pm->finish_time, pm->finish_time - pm->arrival_time);
+        else fprintf(out, "-\t-\t");
+        fprintf(out, "%d\t", ticks[READY]);
+        if (pm->first_run_time >= 0) fprintf(out, "%d\t", pm->first_run_time - pm->arrival_time);
+        else fprintf(out, "-\t");
+        fprintf(out, "%d\t%d\n", ticks[BLOCKED], pm->dispatches);
+    }
+
+    fprintf(out, "\n");
+    fprintf(out, "ticks\t%d\n", m->ticks);
+    fprintf(out, "processes created\t%d\n", m->processes_created);
+    fprintf(out, "processes finished\t%d\n", m->processes_finished);
+    fprintf(out, "avg turnaround\t%.2f\n", average(m->total_turnaround, m->processes_finished));
+    fprintf(out, "avg waiting\t%.2f\n", average(m->total_waiting, m->processes_finished));
+    fprintf(out, "avg response\t%.2f\n", average(m->total_response, m->responded));
+    fprintf(out, "cpu utilisation\t%.2f%%\n", m->ticks > 0 ? 100.0 * m->busy_ticks / m->ticks : 0.0);
+    fprintf(out, "context switches\t%d\n", m->context_switches);
+
+    // Dispositivos configurados (o 0 por omissão, ilimitado, não é listado)
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        const IoDevice* device = &system->io.devices[d];
+        if (!device->configured || (d == 0 && device->channels == 0)) continue;
+
+        fprintf(out, "device %d\tchannels %d\trequests %ld\tqueued %ld\tcompleted %ld\n",
+                d, device->channels, device->requests, device->queued, device->completed);
+    }
+}
@@ -0,0 +1,70 @@
+#include <stdlib.h>
+#include "include/mpsc.h"
+
+/**
+ * Creates a new empty queue.
+ */
+MpscQueue* createMpscQueue() {
+    MpscQueue *queue = (MpscQueue*)malloc(sizeof(MpscQueue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    atomic_init(&queue->stub.next, NULL);
+    atomic_init(&queue->head, &queue->stub);
+    queue->tail = &queue->stub;
+    return queue;
+}
+
+/**
+ * Adds a node to the queue. Safe to call from any number of threads.
+ */
+void mpscPush(MpscQueue *queue, MpscNode *node) {
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    MpscNode *prev = atomic_exchange_explicit(&queue->head, node, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+}
+
+/**
+ * Removes the oldest node, or returns NULL if the queue is empty (or a
+ * producer is half-way through a push; its node shows up on a later call).
+ * Consumer thread only.
+ */
+MpscNode* mpscPop(MpscQueue *queue) {
+    MpscNode *tail = queue->tail;
+    MpscNode *next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+    if (tail == &queue->stub) {  // Salta o nó stub
+        if (next == NULL) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&next->next, memory_order_acquire);
+    }
+
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+
+    if (tail != atomic_load_explicit(&queue->head, memory_order_acquire)) {
+        return NULL;  // Push em curso
+    }
+
+    // tail é o último nó: volta a inserir o stub para o poder retirar
+    mpscPush(queue, &queue->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+/**
+ * Deletes the queue. Nodes still queued are owned by the caller and must be
+ * popped (and freed) first.
+ */
+void deleteMpscQueue(MpscQueue *queue) {
+    free(queue);
+}
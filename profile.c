@@ -0,0 +1,123 @@
+#include "include/profile.h"
+#include "include/timer.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define PROFILE_HAS_TSC 1
+#endif
+
+static const char* const phase_names[NUM_PHASES] = {
+    "exit", "blocked", "new", "execute", "schedule", "metrics", "output"
+};
+
+/* Clock */
+static inline uint64_t read_clock(const PhaseProfiler* profiler) {
+#ifdef PROFILE_HAS_TSC
+    if (profiler->use_tsc) return __rdtsc();
+#endif
+    (void)profiler;
+    return timer_now_ns();
+}
+
+// Nanossegundos por unidade do relógio, medidos desde o início
+static double clock_scale(const PhaseProfiler* profiler) {
+    if (!profiler->use_tsc) return 1.0;
+
+    uint64_t clock = read_clock(profiler) - profiler->start_clock;
+    uint64_t ns = timer_now_ns() - profiler->start_ns;
+    return clock > 0 ? (double)ns / clock : 1.0;
+}
+
+/* Histogram */
+static int bucket_of(uint64_t value) {
+    if (value < PROFILE_SUB_BUCKETS) return (int)value;
+
+    int exponent = 63 - __builtin_clzll(value);     // >= 4
+    int sub = (int)(value >> (exponent - 4)) & (PROFILE_SUB_BUCKETS - 1);
+    return (exponent - 3) * PROFILE_SUB_BUCKETS + sub;
+}
+
+// Upper bound of the values counted in bucket
+static uint64_t bucket_limit(int bucket) {
+    if (bucket < PROFILE_SUB_BUCKETS) return (uint64_t)bucket;
+
+    int exponent = bucket / PROFILE_SUB_BUCKETS + 3;
+    uint64_t sub = (uint64_t)(bucket % PROFILE_SUB_BUCKETS);
+    return ((PROFILE_SUB_BUCKETS + sub + 1) << (exponent - 4)) - 1;
+}
+
+uint64_t latency_histogram_quantile(const LatencyHistogram* histogram, double q) {
+    if (histogram->samples == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * (double)histogram->samples);
+    if (rank >= histogram->samples) rank = histogram->samples - 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < PROFILE_BUCKETS; bucket++) {
+        seen += histogram->counts[bucket];
+        if (seen > rank) {
+            uint64_t limit = bucket_limit(bucket);
+            return limit < histogram->max ? limit : histogram->max;
+        }
+    }
+    return histogram->max;
+}
+
+/* Profiler */
+void phase_profiler_init(PhaseProfiler* profiler, int sample_every) {
+    memset(profiler, 0, sizeof(PhaseProfiler));
+    profiler->sample_every = sample_every > 0 ? sample_every : 1;
+#ifdef PROFILE_HAS_TSC
+    profiler->use_tsc = 1;
+#endif
+    profiler->start_ns = timer_now_ns();
+    profiler->start_clock = read_clock(profiler);
+}
+
+uint64_t phase_profiler_begin(PhaseProfiler* profiler) {
+    if (profiler->countdown > 0) {
+        profiler->countdown--;
+        return 0;
+    }
+    profiler->countdown = profiler->sample_every - 1;
+    uint64_t now = read_clock(profiler);
+    return now ? now : 1;
+}
+
+uint64_t phase_profiler_record(PhaseProfiler* profiler, int phase, uint64_t mark) {
+    uint64_t now = read_clock(profiler);
+    uint64_t elapsed = now > mark ? now - mark : 0;
+    LatencyHistogram* histogram = &profiler->phases[phase];
+
+    histogram->counts[bucket_of(elapsed)]++;
+    histogram->samples++;
+    histogram->total += elapsed;
+    if (elapsed > histogram->max) histogram->max = elapsed;
+    return now;
+}
+
+/* Report */
+void phase_profiler_print(const PhaseProfiler* profiler, FILE* out) {
+    double scale = clock_scale(profiler);
+    uint64_t total = 0;
+    for (int phase = 0; phase < NUM_PHASES; phase++) {
+        total += profiler->phases[phase].total;
+    }
+
+    fprintf(out, "%-10s %10s %10s %6s %9s %9s %9s %9s %9s\n",
+            "phase", "samples", "total ms", "%", "mean ns", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+    for (int phase = 0; phase < NUM_PHASES; phase++) {
+        const LatencyHistogram* histogram = &profiler->phases[phase];
+        double share = total > 0 ? 100.0 * histogram->total / total : 0.0;
+        double mean = histogram->samples > 0 ? scale * histogram->total / histogram->samples : 0.0;
+
+        fprintf(out, "%-10s %10llu %10.3f %6.1f %9.0f %9.0f %9.0f %9.0f %9.0f\n",
+                phase_names[phase], (unsigned long long)histogram->samples,
+                scale * histogram->total / 1e6, share, mean,
+                scale * latency_histogram_quantile(histogram, 0.50),
+                scale * latency_histogram_quantile(histogram, 0.99),
+                scale * latency_histogram_quantile(histogram, 0.999),
+                scale * histogram->max);
+    }
+    fprintf(out, "%-10s %10s %10.3f (1 in %d ticks, %s)\n", "total", "", scale * total / 1e6,
+            profiler->sample_every, profiler->use_tsc ? "TSC" : "clock_gettime");
+}
@@ -11,14 +11,46 @@ Queue* createQueue() {
     queue->front = NULL;
     queue->rear = NULL;
     queue->size = 0;
+    queue->node_pool = NULL;
     return queue;
 }
 
+/**
+ * Creates a new empty queue whose nodes (and the queue itself) live in the
+ * pool's arena. Released together with the arena.
+ */
+Queue* createPooledQueue(ArenaPool *node_pool) {
+    Queue *queue = (Queue*)arena_alloc(node_pool->arena, sizeof(Queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->front = NULL;
+    queue->rear = NULL;
+    queue->size = 0;
+    queue->node_pool = node_pool;
+    return queue;
+}
+
+static QueueNode* allocNode(Queue *queue) {
+    if (queue->node_pool != NULL) {
+        return (QueueNode*)arena_pool_alloc(queue->node_pool);
+    }
+    return (QueueNode*)malloc(sizeof(QueueNode));
+}
+
+static void releaseNode(Queue *queue, QueueNode *node) {
+    if (queue->node_pool != NULL) {
+        arena_pool_free(queue->node_pool, node);
+    } else {
+        free(node);
+    }
+}
+
 /**
  * Adds an element to the end of the queue.
  */
 void enqueue(Queue *queue, void *data) {
-    QueueNode *newNode = (QueueNode*)malloc(sizeof(QueueNode));
+    QueueNode *newNode = allocNode(queue);
     if (newNode == NULL) {
         return;
     }
@@ -51,7 +83,7 @@ void* dequeue(Queue *queue) {
         queue->rear = NULL;
     }
 
-    free(temp);
+    releaseNode(queue, temp);
     queue->size--;
     return data;
 }
@@ -72,12 +104,15 @@ size_t queueSize(Queue *queue) {
 
 /**
  * Deletes the entire queue and frees all allocated memory.
+ * Pooled queues only return their nodes; the arena owns the queue itself.
  */
 void deleteQueue(Queue *queue) {
     while (!isEmpty(queue)) {
         dequeue(queue);
     }
-    free(queue);
+    if (queue->node_pool == NULL) {
+        free(queue);
+    }
 }
 
 /**
@@ -123,7 +158,7 @@ int removeNodeAt(Queue *queue, size_t index) {
         queue->rear = prev;
     }
 
-    free(current);
+    releaseNode(queue, current);
     queue->size--;
     return 1;  // Success
 }
@@ -152,7 +187,7 @@ int removeNodeByData(Queue *queue, void *data) {
                 queue->rear = prev;
             }
 
-            free(current);
+            releaseNode(queue, current);
             queue->size--;
             return 1;  // Success
         }
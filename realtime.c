@@ -0,0 +1,270 @@
+#include "include/realtime.h"
+#include "include/sink.h"
+#include "include/timer.h"
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct {
+    int fd;                 // -1 se o slot está livre
+    char in[RT_LINE_MAX];   // Bytes recebidos ainda sem '\n'
+    int in_len;
+} RtClient;
+
+typedef struct {
+    int listen_fd;
+    RtClient clients[RT_MAX_CLIENTS];
+    int pending_spawns;     // SPAWNs aceites que só são criados no próximo tick
+    int quit;
+} RtServer;
+
+/* Socket helpers */
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int open_listener(const char* path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, RT_MAX_CLIENTS) < 0 ||
+        set_nonblocking(fd) < 0) {
+        perror("bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void close_client(RtClient* client) {
+    close(client->fd);
+    client->fd = -1;
+    client->in_len = 0;
+}
+
+/**
+ * Sends a reply without ever blocking: a client that cannot take it
+ * right away is disconnected.
+ */
+static void reply(RtClient* client, const char* text) {
+    size_t len = strlen(text);
+    ssize_t sent = send(client->fd, text, len, MSG_NOSIGNAL);
+    if (sent != (ssize_t)len) {
+        close_client(client);
+    }
+}
+
+/* Commands */
+static void reply_state(RtClient* client, const SimulationSystem* system) {
+    char line[RT_LINE_MAX + MAX_PROCESSES * 16];
+    int len = snprintf(line, sizeof(line), "time %d new %d ready %d run %d blocked %d exit %d |",
+                       system->current_time,
+                       system->state_counts[NEW], system->state_counts[READY],
+                       system->running_process ? system->running_process->pid : 0,
+                       system->state_counts[BLOCKED], system->state_counts[EXIT]);
+
+    for (int slot = procset_next(&system->live_set, 0); slot >= 0 && len < (int)sizeof(line) - 32;
+         slot = procset_next(&system->live_set, slot + 1)) {
+        len += snprintf(line + len, sizeof(line) - len, " %d:%s",
+                        slot + 1, state_name(system->processes[slot]->state));
+    }
+    snprintf(line + len, sizeof(line) - len, "\n");
+    reply(client, line);
+}
+
+static void execute_command(RtServer* server, RtClient* client, SimulationSystem* system, char* line) {
+    char* command = strtok(line, " \t\r");
+    if (!command) return;
+
+    if (strcmp(command, "SPAWN") == 0) {
+        char* arg = strtok(NULL, " \t\r");
+        int prog_id = arg ? atoi(arg) : -1;
+        if (prog_id < 0 || prog_id >= 5) {
+            reply(client, "ERR invalid program\n");
+        } else if (system->next_pid + server->pending_spawns > MAX_PROCESSES) {
+            // Os PIDs não são reutilizados: o pedido seria descartado no tick
+            reply(client, "ERR table full\n");
+        } else if (!submit_process(system, prog_id)) {
+            reply(client, "ERR out of memory\n");
+        } else {
+            server->pending_spawns++;
+            reply(client, "OK\n");
+        }
+    } else if (strcmp(command, "PROGRAM") == 0) {
+        char* arg = strtok(NULL, " \t\r");
+        int prog_id = arg ? atoi(arg) : -1;
+        int instructions[20];
+        int count = 0;
+
+        while (count < 20 && (arg = strtok(NULL, " \t\r")) != NULL) {
+            instructions[count++] = atoi(arg);
+        }
+        reply(client, set_program(system, prog_id, instructions, count) ? "OK\n" : "ERR invalid program\n");
+    } else if (strcmp(command, "STATE") == 0) {
+        reply_state(client, system);
+    } else if (strcmp(command, "QUIT") == 0) {
+        server->quit = 1;
+        reply(client, "OK\n");
+    } else {
+        reply(client, "ERR unknown command\n");
+    }
+}
+
+/**
+ * Handles at most `budget` complete lines buffered for this client.
+ * Returns how many were handled.
+ */
+static int process_lines(RtServer* server, RtClient* client, SimulationSystem* system, int budget) {
+    int handled = 0;
+
+    while (client->fd >= 0 && handled < budget) {
+        char* newline = memchr(client->in, '\n', client->in_len);
+        if (!newline) break;
+
+        int line_len = (int)(newline - client->in);
+        char line[RT_LINE_MAX];
+        memcpy(line, client->in, line_len);
+        line[line_len] = '\0';
+
+        client->in_len -= line_len + 1;
+        memmove(client->in, newline + 1, client->in_len);
+
+        execute_command(server, client, system, line);
+        handled++;
+    }
+    return handled;
+}
+
+/**
+ * Accepts clients, reads what is available and runs a bounded number of
+ * commands. Never blocks.
+ */
+static int poll_clients(RtServer* server, SimulationSystem* system) {
+    int fd;
+    while ((fd = accept(server->listen_fd, NULL, NULL)) >= 0) {
+        int placed = 0;
+        for (int i = 0; i < RT_MAX_CLIENTS && !placed; i++) {
+            if (server->clients[i].fd < 0 && set_nonblocking(fd) == 0) {
+                server->clients[i].fd = fd;
+                server->clients[i].in_len = 0;
+                placed = 1;
+            }
+        }
+        if (!placed) close(fd);
+    }
+
+    int budget = RT_MAX_COMMANDS_PER_TICK;
+    for (int i = 0; i < RT_MAX_CLIENTS && budget > 0; i++) {
+        RtClient* client = &server->clients[i];
+        if (client->fd < 0) continue;
+
+        // Só lê mais quando não há linhas completas pendentes
+        if (!memchr(client->in, '\n', client->in_len)) {
+            ssize_t n = recv(client->fd, client->in + client->in_len, RT_LINE_MAX - client->in_len, 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                close_client(client);
+                continue;
+            }
+            if (n > 0) client->in_len += (int)n;
+
+            if (client->in_len == RT_LINE_MAX && !memchr(client->in, '\n', client->in_len)) {
+                reply(client, "ERR line too long\n");
+                if (client->fd >= 0) close_client(client);
+                continue;
+            }
+        }
+        budget -= process_lines(server, client, system, budget);
+    }
+    return RT_MAX_COMMANDS_PER_TICK - budget;
+}
+
+static void sleep_until(uint64_t deadline_ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+}
+
+/* main flow */
+int run_realtime(SimulationSystem* system, const RealtimeConfig* config, RealtimeStats* stats) {
+    RtServer server;
+    memset(stats, 0, sizeof(RealtimeStats));
+
+    server.quit = 0;
+    server.pending_spawns = 0;
+    server.listen_fd = open_listener(config->socket_path);
+    if (server.listen_fd < 0) return -1;
+    for (int i = 0; i < RT_MAX_CLIENTS; i++) {
+        server.clients[i].fd = -1;
+        server.clients[i].in_len = 0;
+    }
+
+    uint64_t period = (uint64_t)(1e9 / (config->tick_hz > 0 ? config->tick_hz : 1.0));
+    uint64_t deadline = timer_now_ns();
+
+    while (!server.quit && (config->max_ticks <= 0 || system->current_time < config->max_ticks)) {
+        stats->commands += poll_clients(&server, system);
+
+        simulation_step(system);
+        server.pending_spawns = 0;
+        stats->ticks++;
+
+        deadline += period;
+        uint64_t now = timer_now_ns();
+        if (now > deadline) {
+            // Atrasado: não tenta recuperar em rajada se já perdeu um período
+            stats->late_ticks++;
+            if (now - deadline > period) deadline = now;
+        } else {
+            sleep_until(deadline);
+        }
+    }
+
+    sinks_finish(system);
+
+    for (int i = 0; i < RT_MAX_CLIENTS; i++) {
+        if (server.clients[i].fd >= 0) close_client(&server.clients[i]);
+    }
+    close(server.listen_fd);
+    unlink(config->socket_path);
+    return 0;
+}
+
+#else
+
+int run_realtime(SimulationSystem* system, const RealtimeConfig* config, RealtimeStats* stats) {
+    (void)system;
+    (void)config;
+    memset(stats, 0, sizeof(RealtimeStats));
+    fprintf(stderr, "Real-time mode needs Unix domain sockets (not available on this platform)\n");
+    return -1;
+}
+
+#endif /* _WIN32 */
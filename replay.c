@@ -0,0 +1,399 @@
+#include <stdint.h>
+#include "include/replay.h"
+#include "include/checkpoint.h"
+
+struct ReplayLog {
+    FILE* file;
+    int keyframe_every;
+    int failed;
+    OutputSink sink;
+    CheckpointBuffer keyframe;  // Reutilizado entre keyframes
+    int* keyframe_times;
+    long* keyframe_offsets;
+    int keyframe_count;
+    int keyframe_capacity;
+    int end_time;
+};
+
+typedef struct {
+    int type;
+    int time;
+    int arg;
+    int count;              // PROGRAM: nº de instruções; KEYFRAME: tamanho
+    int instructions[MAX_INSTRUCTIONS];
+} ReplayRecord;
+
+struct ReplayReader {
+    FILE* file;
+    int* keyframe_times;
+    long* keyframe_offsets;
+    int keyframe_count;
+    int end_time;           // -1 se o log não chegou ao fim
+    ReplayRecord pending;   // Próximo registo já lido
+    int has_pending;
+    int at_eof;
+    int dispatched;         // PID despachado no tick corrente (0 = nenhum)
+    long divergences;
+    OutputSink verify_sink;
+};
+
+/* Encoding */
+static void write_int(ReplayLog* log, int value) {
+    int32_t v = (int32_t)value;
+    if (fwrite(&v, sizeof(v), 1, log->file) != 1) log->failed = 1;
+}
+
+static void write_long(ReplayLog* log, long value) {
+    int64_t v = (int64_t)value;
+    if (fwrite(&v, sizeof(v), 1, log->file) != 1) log->failed = 1;
+}
+
+static int read_int(FILE* file, int* value) {
+    int32_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+static int read_long(FILE* file, long* value) {
+    int64_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (long)v;
+    return 1;
+}
+
+static void write_record(ReplayLog* log, int type, int time, int arg) {
+    write_int(log, type);
+    write_int(log, time);
+    write_int(log, arg);
+}
+
+/* Recording */
+static void write_keyframe(ReplayLog* log, const SimulationSystem* system) {
+    if (log->keyframe_count == log->keyframe_capacity) {
+        int capacity = log->keyframe_capacity ? log->keyframe_capacity * 2 : 64;
+        int* times = (int*)realloc(log->keyframe_times, capacity * sizeof(int));
+        if (times) log->keyframe_times = times;
+        long* offsets = (long*)realloc(log->keyframe_offsets, capacity * sizeof(long));
+        if (offsets) log->keyframe_offsets = offsets;
+        if (!times || !offsets) {
+            log->failed = 1;
+            return;
+        }
+        log->keyframe_capacity = capacity;
+    }
+
+    log->keyframe.size = 0;
+    if (!checkpoint_save(system, &log->keyframe)) {
+        log->failed = 1;
+        return;
+    }
+
+    log->keyframe_times[log->keyframe_count] = system->current_time;
+    log->keyframe_offsets[log->keyframe_count] = ftell(log->file);
+    log->keyframe_count++;
+
+    write_record(log, REPLAY_KEYFRAME, system->current_time, 0);
+    write_int(log, (int)log->keyframe.size);
+    if (fwrite(log->keyframe.data, 1, log->keyframe.size, log->file) != log->keyframe.size) {
+        log->failed = 1;
+    }
+}
+
+static void replay_log_transition(OutputSink* sink, const SimulationSystem* system,
+                                  const PCB* process, int from, int to) {
+    if (to == RUNNING && from != NO_STATE) {
+        write_record((ReplayLog*)sink->ctx, REPLAY_SCHEDULE, system->current_time, process->pid);
+    }
+}
+
+static void replay_log_tick(OutputSink* sink, SimulationSystem* system) {
+    ReplayLog* log = (ReplayLog*)sink->ctx;
+    if (system->current_time % log->keyframe_every == 0) {
+        write_keyframe(log, system);
+    }
+}
+
+static void replay_log_finish(OutputSink* sink, SimulationSystem* system) {
+    ReplayLog* log = (ReplayLog*)sink->ctx;
+    log->end_time = system->current_time;
+    write_record(log, REPLAY_END, system->current_time, 0);
+}
+
+ReplayLog* replay_log_open(const char* path, int keyframe_every) {
+    ReplayLog* log = (ReplayLog*)calloc(1, sizeof(ReplayLog));
+    if (!log) return NULL;
+
+    log->file = fopen(path, "wb");
+    if (!log->file) {
+        free(log);
+        return NULL;
+    }
+    log->keyframe_every = keyframe_every > 0 ? keyframe_every : REPLAY_DEFAULT_KEYFRAME_EVERY;
+    log->end_time = -1;
+    log->sink.on_transition = replay_log_transition;
+    log->sink.on_tick = replay_log_tick;
+    log->sink.on_finish = replay_log_finish;
+    log->sink.ctx = log;
+
+    write_int(log, (int)REPLAY_MAGIC);
+    write_int(log, REPLAY_VERSION);
+    write_int(log, MAX_PROCESSES);
+    return log;
+}
+
+/**
+ * Starts recording system: writes the initial keyframe, hooks the input
+ * paths and registers the sink that logs dispatches and later keyframes.
+ */
+int replay_log_attach(ReplayLog* log, SimulationSystem* system) {
+    if (!log || !system) return 0;
+
+    write_keyframe(log, system);
+    system->replay_log = log;
+    return simulation_add_sink(system, &log->sink) && !log->failed;
+}
+
+void replay_record_spawn(ReplayLog* log, int time, int program_id) {
+    write_record(log, REPLAY_SPAWN, time, program_id);
+}
+
+void replay_record_program(ReplayLog* log, int time, int prog_id, const int* instructions, int count) {
+    if (count > MAX_INSTRUCTIONS) count = MAX_INSTRUCTIONS;
+
+    write_record(log, REPLAY_PROGRAM, time, prog_id);
+    write_int(log, count);
+    for (int i = 0; i < count; i++) {
+        write_int(log, instructions[i]);
+    }
+}
+
+/**
+ * Writes the keyframe index and the trailer (index offset + magic) and
+ * detaches the log from system.
+ */
+void replay_log_close(ReplayLog* log, SimulationSystem* system) {
+    if (!log) return;
+
+    if (system && system->replay_log == log) {
+        system->replay_log = NULL;
+    }
+
+    long index_offset = ftell(log->file);
+    write_record(log, REPLAY_INDEX, log->end_time, log->keyframe_count);
+    for (int i = 0; i < log->keyframe_count; i++) {
+        write_int(log, log->keyframe_times[i]);
+        write_long(log, log->keyframe_offsets[i]);
+    }
+    write_long(log, index_offset);
+    write_int(log, (int)REPLAY_MAGIC);
+
+    if (fclose(log->file) != 0 || log->failed) {
+        fprintf(stderr, "Error writing replay log\n");
+    }
+    checkpoint_buffer_free(&log->keyframe);
+    free(log->keyframe_times);
+    free(log->keyframe_offsets);
+    free(log);
+}
+
+/* Playback */
+/**
+ * Reads the next record. Program payloads are decoded; keyframe payloads
+ * are skipped (count holds their size).
+ */
+static int read_record(FILE* file, ReplayRecord* record) {
+    if (!read_int(file, &record->type) || !read_int(file, &record->time) || !read_int(file, &record->arg)) {
+        return 0;
+    }
+    record->count = 0;
+
+    if (record->type == REPLAY_PROGRAM) {
+        if (!read_int(file, &record->count) || record->count < 0 || record->count > MAX_INSTRUCTIONS) return 0;
+        for (int i = 0; i < record->count; i++) {
+            if (!read_int(file, &record->instructions[i])) return 0;
+        }
+    } else if (record->type == REPLAY_KEYFRAME) {
+        if (!read_int(file, &record->count) || record->count < 0) return 0;
+        if (fseek(file, record->count, SEEK_CUR) != 0) return 0;
+    } else if (record->type < REPLAY_SPAWN || record->type > REPLAY_END) {
+        return 0;
+    }
+    return 1;
+}
+
+static int add_keyframe(ReplayReader* reader, int time, long offset) {
+    int n = reader->keyframe_count;
+    int* times = (int*)realloc(reader->keyframe_times, (n + 1) * sizeof(int));
+    if (times) reader->keyframe_times = times;
+    long* offsets = (long*)realloc(reader->keyframe_offsets, (n + 1) * sizeof(long));
+    if (offsets) reader->keyframe_offsets = offsets;
+    if (!times || !offsets) return 0;
+
+    reader->keyframe_times[n] = time;
+    reader->keyframe_offsets[n] = offset;
+    reader->keyframe_count++;
+    return 1;
+}
+
+// Index written by replay_log_close()
+static int load_index(ReplayReader* reader) {
+    long index_offset;
+    int magic, type, end_time, count;
+
+    if (fseek(reader->file, -(long)(sizeof(int64_t) + sizeof(int32_t)), SEEK_END) != 0 ||
+        !read_long(reader->file, &index_offset) || !read_int(reader->file, &magic) ||
+        (uint32_t)magic != REPLAY_MAGIC || fseek(reader->file, index_offset, SEEK_SET) != 0 ||
+        !read_int(reader->file, &type) || type != REPLAY_INDEX ||
+        !read_int(reader->file, &end_time) || !read_int(reader->file, &count) || count < 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int time;
+        long offset;
+        if (!read_int(reader->file, &time) || !read_long(reader->file, &offset) ||
+            !add_keyframe(reader, time, offset)) {
+            return 0;
+        }
+    }
+    reader->end_time = end_time;
+    return 1;
+}
+
+// Log de uma execução interrompida: percorre os registos
+static int scan_records(ReplayReader* reader, long start) {
+    ReplayRecord record;
+    long offset = start;
+
+    if (fseek(reader->file, start, SEEK_SET) != 0) return 0;
+    while (read_record(reader->file, &record)) {
+        if (record.type == REPLAY_KEYFRAME && !add_keyframe(reader, record.time, offset)) return 0;
+        if (record.type == REPLAY_END) reader->end_time = record.time;
+        offset = ftell(reader->file);
+    }
+    return 1;
+}
+
+static void replay_verify_transition(OutputSink* sink, const SimulationSystem* system,
+                                     const PCB* process, int from, int to) {
+    (void)system;
+    if (to == RUNNING && from != NO_STATE) {
+        ((ReplayReader*)sink->ctx)->dispatched = process->pid;
+    }
+}
+
+ReplayReader* replay_open(const char* path) {
+    ReplayReader* reader = (ReplayReader*)calloc(1, sizeof(ReplayReader));
+    if (!reader) return NULL;
+
+    int magic, version, max_processes;
+    reader->file = fopen(path, "rb");
+    reader->end_time = -1;
+    if (!reader->file || !read_int(reader->file, &magic) || !read_int(reader->file, &version) ||
+        !read_int(reader->file, &max_processes) || (uint32_t)magic != REPLAY_MAGIC ||
+        version != REPLAY_VERSION || max_processes != MAX_PROCESSES) {
+        replay_close(reader);
+        return NULL;
+    }
+
+    long start = ftell(reader->file);
+    if (!load_index(reader)) {
+        reader->keyframe_count = 0;
+        reader->end_time = -1;
+        if (!scan_records(reader, start)) {
+            replay_close(reader);
+            return NULL;
+        }
+    }
+
+    reader->verify_sink.on_transition = replay_verify_transition;
+    reader->verify_sink.ctx = reader;
+    return reader;
+}
+
+void replay_close(ReplayReader* reader) {
+    if (!reader) return;
+
+    if (reader->file) fclose(reader->file);
+    free(reader->keyframe_times);
+    free(reader->keyframe_offsets);
+    free(reader);
+}
+
+/**
+ * system is overwritten (as by checkpoint_restore) and keeps only the
+ * verification sink; add the table sink afterwards to print from time on.
+ */
+int replay_seek(ReplayReader* reader, SimulationSystem* system, int time) {
+    int best = -1;
+    for (int i = 0; i < reader->keyframe_count; i++) {
+        if (reader->keyframe_times[i] <= time &&
+            (best < 0 || reader->keyframe_times[i] >= reader->keyframe_times[best])) {
+            best = i;
+        }
+    }
+    if (best < 0) return -1;
+
+    int type, keyframe_time, arg, size;
+    if (fseek(reader->file, reader->keyframe_offsets[best], SEEK_SET) != 0 ||
+        !read_int(reader->file, &type) || !read_int(reader->file, &keyframe_time) ||
+        !read_int(reader->file, &arg) || !read_int(reader->file, &size) ||
+        type != REPLAY_KEYFRAME || size < 0) {
+        return -1;
+    }
+
+    unsigned char* data = (unsigned char*)malloc(size ? size : 1);
+    int ok = data && fread(data, 1, size, reader->file) == (size_t)size &&
+             checkpoint_restore(system, data, size);
+    free(data);
+    if (!ok) return -1;
+
+    simulation_clear_sinks(system);
+    simulation_add_sink(system, &reader->verify_sink);
+    reader->has_pending = 0;
+    reader->at_eof = 0;
+
+    while (system->current_time < time && replay_step(reader, system)) {
+    }
+    return keyframe_time;
+}
+
+int replay_step(ReplayReader* reader, SimulationSystem* system) {
+    int next = system->current_time + 1;
+    int expected = 0;
+
+    if (reader->end_time >= 0 && next > reader->end_time) return 0;
+
+    // Entradas do próximo tick (os registos estão por ordem de tempo)
+    while (reader->has_pending || (!reader->at_eof && read_record(reader->file, &reader->pending))) {
+        ReplayRecord* record = &reader->pending;
+        reader->has_pending = 1;
+        if (record->time > next) break;
+
+        if (record->time == next) {
+            if (record->type == REPLAY_PROGRAM) {
+                set_program(system, record->arg, record->instructions, record->count);
+            } else if (record->type == REPLAY_SPAWN) {
+                submit_process(system, record->arg);
+            } else if (record->type == REPLAY_SCHEDULE) {
+                expected = record->arg;
+            }
+        }
+        reader->has_pending = 0;
+    }
+    if (!reader->has_pending) reader->at_eof = 1;
+
+    reader->dispatched = 0;
+    int running = simulation_step(system);
+    if (reader->dispatched != expected) {
+        reader->divergences++;
+    }
+    // Sem trace de chegadas, um tick sem processos não marca o fim
+    if (reader->end_time >= 0) return system->current_time < reader->end_time;
+    return running || !reader->at_eof;
+}
+
+long replay_divergences(const ReplayReader* reader) {
+    return reader->divergences;
+}
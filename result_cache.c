@@ -0,0 +1,221 @@
+#include "include/result_cache.h"
+
+void result_cache_key(const SimulationSystem* system, ResultCacheKey* key) {
+    memset(key, 0, sizeof(ResultCacheKey));  // Sem lixo no padding: a chave é hashed byte a byte
+    key->engine_version = SIM_ENGINE_VERSION;
+    key->max_processes = MAX_PROCESSES;
+    key->max_ticks = system->max_ticks;
+
+    for (int i = 0; i < 5; i++) {
+        key->program_lengths[i] = system->program_lengths[i];
+        for (int j = 0; j < MAX_INSTRUCTIONS; j++) {
+            key->programs[i][j] = system->programs[i][j];
+        }
+    }
+    for (int d = 0; d < MAX_DEVICES; d++) {
+        key->devices[d][0] = system->io.devices[d].configured;
+        key->devices[d][1] = system->io.devices[d].configured ? system->io.devices[d].channels : 0;
+    }
+}
+
+#ifndef _WIN32
+
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+
+#define MAX_ENTRIES 4096    // Entradas consideradas por varrimento de despejo
+
+/* Helpers */
+// FNV-1a 64 bits
+static uint64_t hash_key(const ResultCacheKey* key) {
+    const unsigned char* bytes = (const unsigned char*)key;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < sizeof(ResultCacheKey); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void entry_path(char* path, size_t size, const char* dir, const ResultCacheKey* key) {
+    snprintf(path, size, "%s/%016llx.res", dir, (unsigned long long)hash_key(key));
+}
+
+static int copy_bytes(FILE* from, FILE* to, long size) {
+    char chunk[8192];
+    while (size > 0) {
+        size_t n = size < (long)sizeof(chunk) ? (size_t)size : sizeof(chunk);
+        if (fread(chunk, 1, n, from) != n || fwrite(chunk, 1, n, to) != n) return 0;
+        size -= (long)n;
+    }
+    return 1;
+}
+
+static int write_section(FILE* entry, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+
+    int ok = fseek(file, 0, SEEK_END) == 0;
+    long size = ftell(file);
+    int64_t size64 = size;
+    ok = ok && size >= 0 && fseek(file, 0, SEEK_SET) == 0 &&
+         fwrite(&size64, sizeof(size64), 1, entry) == 1 && copy_bytes(file, entry, size);
+    fclose(file);
+    return ok;
+}
+
+// Escreve para um temporário e renomeia: quem lê nunca vê metade
+static int read_section(FILE* entry, const char* path) {
+    int64_t size64;
+    if (fread(&size64, sizeof(size64), 1, entry) != 1 || size64 < 0) return 0;
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%ld", path, (long)getpid());
+    FILE* file = fopen(tmp, "wb");
+    if (!file) return 0;
+
+    int ok = copy_bytes(entry, file, (long)size64);
+    if (fclose(file) != 0) ok = 0;
+    if (ok && rename(tmp, path) != 0) ok = 0;
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+/* Eviction */
+typedef struct {
+    char name[64];
+    time_t used;
+    long size;
+} CacheEntry;
+
+static int compare_entries(const void* a, const void* b) {
+    time_t ta = ((const CacheEntry*)a)->used;
+    time_t tb = ((const CacheEntry*)b)->used;
+    return ta < tb ? -1 : ta > tb;
+}
+
+/**
+ * Deletes the least recently used entries until the directory holds at
+ * most max_bytes. Another worker may delete the same entry first; that is
+ * harmless.
+ */
+static void evict(const char* dir, long max_bytes) {
+    DIR* handle = opendir(dir);
+    if (!handle) return;
+
+    CacheEntry* entries = (CacheEntry*)malloc(MAX_ENTRIES * sizeof(CacheEntry));
+    if (!entries) {
+        closedir(handle);
+        return;
+    }
+
+    int count = 0;
+    long total = 0;
+    struct dirent* dirent;
+    while ((dirent = readdir(handle)) != NULL && count < MAX_ENTRIES) {
+        size_t len = strlen(dirent->d_name);
+        if (len < 4 || len >= sizeof(entries[0].name) || strcmp(dirent->d_name + len - 4, ".res") != 0) {
+            continue;
+        }
+
+        char path[512];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", dir, dirent->d_name);
+        if (stat(path, &st) != 0) continue;
+
+        strcpy(entries[count].name, dirent->d_name);
+        entries[count].used = st.st_mtime;
+        entries[count].size = (long)st.st_size;
+        total += entries[count].size;
+        count++;
+    }
+    closedir(handle);
+
+    qsort(entries, count, sizeof(CacheEntry), compare_entries);
+    for (int i = 0; i < count && total > max_bytes; i++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir, entries[i].name);
+        if (remove(path) == 0 || errno == ENOENT) {
+            total -= entries[i].size;
+        }
+    }
+    free(entries);
+}
+
+/* Lookup / store */
+int result_cache_lookup(const char* dir, const ResultCacheKey* key,
+                        const char* out_path, const char* stats_path) {
+    char path[512];
+    entry_path(path, sizeof(path), dir, key);
+
+    FILE* entry = fopen(path, "rb");
+    if (!entry) return 0;
+
+    // A chave completa vai na entrada: uma colisão do hash é só um miss
+    uint32_t magic;
+    ResultCacheKey stored;
+    int hit = fread(&magic, sizeof(magic), 1, entry) == 1 && magic == RESULT_CACHE_MAGIC &&
+              fread(&stored, sizeof(stored), 1, entry) == 1 &&
+              memcmp(&stored, key, sizeof(ResultCacheKey)) == 0 &&
+              read_section(entry, out_path) && read_section(entry, stats_path);
+    fclose(entry);
+
+    if (hit) {
+        utime(path, NULL);  // Marca como usada recentemente (LRU)
+    }
+    return hit;
+}
+
+int result_cache_store(const char* dir, long max_bytes, const ResultCacheKey* key,
+                       const char* out_path, const char* stats_path) {
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) return 0;
+
+    char path[512], tmp[560];
+    entry_path(path, sizeof(path), dir, key);
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%ld", path, (long)getpid());
+
+    FILE* entry = fopen(tmp, "wb");
+    if (!entry) return 0;
+
+    uint32_t magic = RESULT_CACHE_MAGIC;
+    int ok = fwrite(&magic, sizeof(magic), 1, entry) == 1 &&
+             fwrite(key, sizeof(ResultCacheKey), 1, entry) == 1 &&
+             write_section(entry, out_path) && write_section(entry, stats_path);
+    if (fclose(entry) != 0) ok = 0;
+    if (ok && rename(tmp, path) != 0) ok = 0;
+    if (!ok) {
+        remove(tmp);
+        return 0;
+    }
+
+    evict(dir, max_bytes);
+    return 1;
+}
+
+#else
+
+int result_cache_lookup(const char* dir, const ResultCacheKey* key,
+                        const char* out_path, const char* stats_path) {
+    (void)dir;
+    (void)key;
+    (void)out_path;
+    (void)stats_path;
+    return 0;
+}
+
+int result_cache_store(const char* dir, long max_bytes, const ResultCacheKey* key,
+                       const char* out_path, const char* stats_path) {
+    (void)dir;
+    (void)max_bytes;
+    (void)key;
+    (void)out_path;
+    (void)stats_path;
+    fprintf(stderr, "Result cache needs POSIX directories (not available on this platform)\n");
+    return 0;
+}
+
+#endif /* _WIN32 */
@@ -0,0 +1,253 @@
+#include "include/shm_ring.h"
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    ShmRingHeader* header;
+    ShmRingSlot* slots;
+    size_t mapped_size;
+    uint64_t next_seq;      // Cópia local de write_seq (só o produtor escreve)
+    uint32_t mask;
+} ShmRing;
+
+static size_t ring_size(uint32_t capacity) {
+    return sizeof(ShmRingHeader) + (size_t)capacity * sizeof(ShmRingSlot);
+}
+
+static void* map_file(int fd, size_t size, int writable) {
+    void* addr = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    return addr == MAP_FAILED ? NULL : addr;
+}
+
+/* Producer */
+static void publish(ShmRing* ring, int type, int time, int pid, int from, int to, int program_id) {
+    uint64_t n = ring->next_seq;
+    ShmRingSlot* slot = &ring->slots[n & ring->mask];
+
+    atomic_store_explicit(&slot->seq, 2 * n + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    atomic_store_explicit(&slot->type, type, memory_order_relaxed);
+    atomic_store_explicit(&slot->time, time, memory_order_relaxed);
+    atomic_store_explicit(&slot->pid, pid, memory_order_relaxed);
+    atomic_store_explicit(&slot->from, from, memory_order_relaxed);
+    atomic_store_explicit(&slot->to, to, memory_order_relaxed);
+    atomic_store_explicit(&slot->program_id, program_id, memory_order_relaxed);
+
+    atomic_store_explicit(&slot->seq, 2 * n + 2, memory_order_release);
+    ring->next_seq = n + 1;
+    atomic_store_explicit(&ring->header->write_seq, n + 1, memory_order_release);
+}
+
+static void shm_ring_transition(OutputSink* sink, const SimulationSystem* system,
+                                const PCB* process, int from, int to) {
+    publish((ShmRing*)sink->ctx, SHM_RECORD_TRANSITION, system->current_time,
+            process->pid, from, to, process->program_id);
+}
+
+static void shm_ring_tick(OutputSink* sink, SimulationSystem* system) {
+    publish((ShmRing*)sink->ctx, SHM_RECORD_TICK, system->current_time, 0, 0, 0, 0);
+}
+
+static void shm_ring_finish(OutputSink* sink, SimulationSystem* system) {
+    publish((ShmRing*)sink->ctx, SHM_RECORD_END, system->current_time, 0, 0, 0, 0);
+}
+
+/**
+ * Creates (or truncates) the ring file and returns a sink that publishes
+ * into it. capacity is rounded up to a power of two.
+ */
+OutputSink* shm_ring_open(const char* path, uint32_t capacity) {
+    uint32_t rounded = 1;
+    while (rounded < capacity && rounded < (1u << 30)) rounded <<= 1;
+
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    ShmRing* ring = (ShmRing*)calloc(1, sizeof(ShmRing));
+    if (!sink || !ring) {
+        free(sink);
+        free(ring);
+        return NULL;
+    }
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)ring_size(rounded)) < 0) {
+        perror("shm ring");
+        if (fd >= 0) close(fd);
+        free(sink);
+        free(ring);
+        return NULL;
+    }
+
+    ring->mapped_size = ring_size(rounded);
+    ring->header = (ShmRingHeader*)map_file(fd, ring->mapped_size, 1);
+    close(fd);
+    if (!ring->header) {
+        perror("mmap");
+        free(sink);
+        free(ring);
+        return NULL;
+    }
+
+    ring->slots = (ShmRingSlot*)(ring->header + 1);
+    ring->mask = rounded - 1;
+    ring->header->version = SHM_RING_VERSION;
+    ring->header->capacity = rounded;
+    ring->header->slot_size = sizeof(ShmRingSlot);
+    atomic_store_explicit(&ring->header->write_seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    ring->header->magic = SHM_RING_MAGIC;  // Por último: o anel está pronto
+
+    sink->on_transition = shm_ring_transition;
+    sink->on_tick = shm_ring_tick;
+    sink->on_finish = shm_ring_finish;
+    sink->ctx = ring;
+    return sink;
+}
+
+void shm_ring_close(OutputSink* sink) {
+    if (!sink) return;
+
+    ShmRing* ring = (ShmRing*)sink->ctx;
+    if (ring) {
+        munmap(ring->header, ring->mapped_size);
+        free(ring);
+    }
+    free(sink);
+}
+
+/* Consumer */
+ShmRingReader* shm_ring_attach(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    ShmRingHeader* header = NULL;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ShmRingHeader)) {
+        header = (ShmRingHeader*)map_file(fd, (size_t)st.st_size, 0);
+    }
+    close(fd);
+    if (!header) return NULL;
+
+    if (header->magic != SHM_RING_MAGIC || header->version != SHM_RING_VERSION ||
+        header->slot_size != sizeof(ShmRingSlot) || ring_size(header->capacity) > (size_t)st.st_size) {
+        munmap(header, (size_t)st.st_size);
+        return NULL;
+    }
+
+    ShmRingReader* reader = (ShmRingReader*)calloc(1, sizeof(ShmRingReader));
+    if (!reader) {
+        munmap(header, (size_t)st.st_size);
+        return NULL;
+    }
+    reader->header = header;
+    reader->slots = (ShmRingSlot*)(header + 1);
+    reader->mapped_size = (size_t)st.st_size;
+
+    // Começa no registo mais antigo ainda disponível
+    uint64_t head = atomic_load_explicit(&header->write_seq, memory_order_acquire);
+    reader->cursor = head > header->capacity ? head - header->capacity : 0;
+    return reader;
+}
+
+/**
+ * Reads the next record. Lock-free: if the producer laps the reader, the
+ * lost records are skipped and their count is returned as a negative value.
+ */
+long shm_ring_read(ShmRingReader* reader, ShmRecord* record) {
+    uint64_t capacity = reader->header->capacity;
+    uint64_t head = atomic_load_explicit(&reader->header->write_seq, memory_order_acquire);
+
+    if (reader->cursor >= head) return 0;
+    if (head - reader->cursor > capacity) {
+        long lost = (long)(head - capacity - reader->cursor);
+        reader->cursor = head - capacity;
+        return -lost;
+    }
+
+    ShmRingSlot* slot = &reader->slots[reader->cursor & (capacity - 1)];
+    uint64_t expected = 2 * reader->cursor + 2;
+    uint64_t before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if (before == expected) {
+        record->type = atomic_load_explicit(&slot->type, memory_order_relaxed);
+        record->time = atomic_load_explicit(&slot->time, memory_order_relaxed);
+        record->pid = atomic_load_explicit(&slot->pid, memory_order_relaxed);
+        record->from = atomic_load_explicit(&slot->from, memory_order_relaxed);
+        record->to = atomic_load_explicit(&slot->to, memory_order_relaxed);
+        record->program_id = atomic_load_explicit(&slot->program_id, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) == before) {
+            reader->cursor++;
+            return 1;
+        }
+    }
+
+    // O slot foi reescrito entretanto: salta para o mais antigo disponível
+    head = atomic_load_explicit(&reader->header->write_seq, memory_order_acquire);
+    uint64_t oldest = head > capacity ? head - capacity : 0;
+    if (oldest <= reader->cursor) oldest = reader->cursor + 1;
+    long lost = (long)(oldest - reader->cursor);
+    reader->cursor = oldest;
+    return -lost;
+}
+
+long shm_ring_read_wait(ShmRingReader* reader, ShmRecord* record, int timeout_ms) {
+    struct timespec pause = {0, 1000000};   // 1 ms entre tentativas
+    long result;
+
+    while ((result = shm_ring_read(reader, record)) == 0 && timeout_ms-- > 0) {
+        nanosleep(&pause, NULL);
+    }
+    return result;
+}
+
+void shm_ring_detach(ShmRingReader* reader) {
+    if (!reader) return;
+
+    munmap(reader->header, reader->mapped_size);
+    free(reader);
+}
+
+#else
+
+OutputSink* shm_ring_open(const char* path, uint32_t capacity) {
+    (void)path;
+    (void)capacity;
+    fprintf(stderr, "Shared-memory ring needs mmap (not available on this platform)\n");
+    return NULL;
+}
+
+void shm_ring_close(OutputSink* sink) {
+    (void)sink;
+}
+
+ShmRingReader* shm_ring_attach(const char* path) {
+    (void)path;
+    return NULL;
+}
+
+long shm_ring_read(ShmRingReader* reader, ShmRecord* record) {
+    (void)reader;
+    (void)record;
+    return 0;
+}
+
+long shm_ring_read_wait(ShmRingReader* reader, ShmRecord* record, int timeout_ms) {
+    (void)reader;
+    (void)record;
+    (void)timeout_ms;
+    return 0;
+}
+
+void shm_ring_detach(ShmRingReader* reader) {
+    (void)reader;
+}
+
+#endif /* _WIN32 */
@@ -1,20 +1,131 @@
 #include "include/simulation.h"
+#include "include/metrics.h"
+#include "include/tracepoint.h"
+#include "include/sink.h"
+#include "include/replay.h"
+#include "include/cycle.h"
+#include "include/burst.h"
+#include "include/analysis.h"
+#include "include/profile.h"
+
+// PCB e cópia do programa numa só alocação do pool
+typedef struct {
+    PCB pcb;
+    int code[MAX_INSTRUCTIONS];
+} ProcessImage;
+
+static const char* const state_names[NUM_STATES] = {"NEW", "READY", "RUN", "BLOCKED", "EXIT"};
+
+/* State bookkeeping */
+static void render_cell(char* cell, const char* state) {
+    size_t len = strlen(state);
+    cell[0] = '\t';
+    memcpy(cell + 1, state, len);
+    memset(cell + 1 + len, ' ', CELL_WIDTH - 1 - len);
+}
+
+/**
+ * Adds an existing process to the per-state sets (no metrics, traces or
+ * sink notifications; used when restoring a checkpoint).
+ */
+void index_process(SimulationSystem* system, PCB* process) {
+    int slot = process->pid - 1;
+    if (slot < 0 || slot >= MAX_PROCESSES) return;
+
+    system->processes[slot] = process;
+    procset_add(&system->live_set, slot);
+    procset_add(&system->state_sets[process->state], slot);
+    system->state_counts[process->state]++;
+    procset_add(&system->dirty_set, slot);
+}
+
+void track_process(SimulationSystem* system, PCB* process) {
+    int slot = process->pid - 1;
+    if (slot < 0 || slot >= MAX_PROCESSES) return;
+
+    index_process(system, process);
+    metrics_process_created(system, process);
+    SIM_TRACE(process_create, system->current_time, process->pid, process->program_id, 0);
+    sinks_transition(system, process, NO_STATE, process->state);
+}
+
+void untrack_process(SimulationSystem* system, PCB* process) {
+    int slot = process->pid - 1;
+    if (slot < 0 || slot >= MAX_PROCESSES || !procset_contains(&system->live_set, slot)) return;
+
+    procset_remove(&system->live_set, slot);
+    procset_remove(&system->state_sets[process->state], slot);
+    system->state_counts[process->state]--;
+    procset_add(&system->dirty_set, slot);
+    sinks_transition(system, process, process->state, NO_STATE);
+}
+
+/**
+ * Every state transition goes through here so that the per-state sets and
+ * counters stay in sync with the PCBs.
+ */
+void set_process_state(SimulationSystem* system, PCB* process, int state) {
+    int slot = process->pid - 1;
+    int from = process->state;
+    if (from == state) return;
+
+    int tracked = slot >= 0 && slot < MAX_PROCESSES && procset_contains(&system->live_set, slot);
+    if (tracked) {
+        procset_remove(&system->state_sets[from], slot);
+        system->state_counts[from]--;
+        procset_add(&system->state_sets[state], slot);
+        system->state_counts[state]++;
+        procset_add(&system->dirty_set, slot);
+        metrics_transition(system, process, from, state);
+    }
+    SIM_TRACE(state_transition, system->current_time, process->pid, from, state);
+    process->state = state;
+
+    if (tracked) {
+        sinks_transition(system, process, from, state);
+    }
+}
+
+int has_live_processes(const SimulationSystem* system) {
+    return !procset_is_empty(&system->live_set);
+}
+
+const char* state_name(int state) {
+    return (state >= 0 && state < NUM_STATES) ? state_names[state] : "?";
+}
 
 /* Init */
-void initialize_system_with_input(SimulationSystem* system, SimulationInput input) {
+/**
+ * Sets up an empty system: queues, devices, arena and the default table
+ * output, but no programs and no processes.
+ */
+void initialize_system(SimulationSystem* system) {
     memset(system, 0, sizeof(SimulationSystem));
 
-    system->ready_queue = createQueue();
-    system->new_queue = createQueue();
-    system->blocked_queue = createQueue();
-    system->exit_queue = createQueue();
+    arena_init(&system->arena, ARENA_DEFAULT_BLOCK);
+    arena_pool_init(&system->process_pool, &system->arena, sizeof(ProcessImage));
+    arena_pool_init(&system->node_pool, &system->arena, sizeof(QueueNode));
+
+    system->ready_queue = createPooledQueue(&system->node_pool);
+    system->new_queue = createPooledQueue(&system->node_pool);
+    io_init(&system->io, &system->node_pool);
+    system->exit_queue = createPooledQueue(&system->node_pool);
+    system->injection_queue = createMpscQueue();
     system->running_process = NULL;
     system->next_pid = 1;
     system->current_time = 0;
+    system->max_ticks = DEFAULT_MAX_TICKS;
+    system->output = stdout;
+    simulation_add_sink(system, &table_output_sink);
 
-    for (int i = 0; i < 20; ++i) {
+    for (int i = 0; i < MAX_PROCESSES; ++i) {
         system->processes[i] = NULL;
+        render_cell(system->row_cells + i * CELL_WIDTH, "");
     }
+}
+
+void initialize_system_with_input(SimulationSystem* system, SimulationInput input) {
+    initialize_system(system);
 
     for(int i = 0; i < input.rows && i < 5; i++) {
         for (int j = 0; j < 20; j++) {
@@ -37,46 +148,54 @@ void initialize_system_with_input(SimulationSystem* system, SimulationInput inpu
         }
     }
 
-    PCB* first_process = (PCB*)calloc(1, sizeof(PCB));
-    first_process->pid = 1;
-    first_process->state = NEW;
-    first_process->time_in_state = 0;
-    first_process->pc = 0;
-    first_process->program_id = 0;
-    first_process->instruction_count = system->program_lengths[0];
-    first_process->instructions = (int*)malloc(first_process->instruction_count * sizeof(int));
-
-    if (!first_process->instructions) {
-        fprintf(stderr, "Memory allocation failed for first process instructions\n");
-        free(first_process);
+    PCB* first_process = create_new_process(system, 0);
+    if (!first_process) {
+        fprintf(stderr, "Memory allocation failed for first process\n");
         exit(1);
     }
+    enqueue(system->new_queue, first_process);
+}
 
-    for (int i = 0; i < first_process->instruction_count; i++) {
-        first_process->instructions[i] = system->programs[0][i];
+/**
+ * Replaces program prog_id (up to 20 instructions, stops at the first 0).
+ * Processes already created keep their own copy of the old program.
+ * Returns 1 on success.
+ */
+int set_program(SimulationSystem* system, int prog_id, const int* instructions, int count) {
+    if (!system || prog_id < 0 || prog_id >= 5 || count < 0) return 0;
+
+    // Aplicado antes do próximo tick
+    if (system->replay_log) {
+        replay_record_program(system->replay_log, system->current_time + 1, prog_id, instructions, count);
     }
-
-    system->processes[0] = first_process;
-    enqueue(system->new_queue, first_process);
-    system->next_pid = 2;
+    system->program_lengths[prog_id] = 20;
+    for (int j = 0; j < 20; j++) {
+        system->programs[prog_id][j] = j < count ? instructions[j] : 0;
+        if (system->programs[prog_id][j] == 0 && system->program_lengths[prog_id] == 20) {
+            system->program_lengths[prog_id] = j;
+        }
+    }
+    return 1;
 }
 
 /* Queue operations */
+/**
+ * Wakes the processes whose I/O completes now (in completion order) and
+ * hands each freed channel to the next request waiting on that device.
+ */
 void update_blocked_processes(SimulationSystem* system) {
-    if (!system->blocked_queue) return;
+    void* data;
+    int device;
 
-    size_t size = queueSize(system->blocked_queue);
-    for (size_t i = 0; i < size; i++) {
-        PCB* proc = (PCB*)getQueueNodeAt(system->blocked_queue, i);
-        if (!proc) continue;
+    while (io_pop_due(&system->io, system->current_time, &data, &device)) {
+        PCB* proc = (PCB*)data;
+        set_process_state(system, proc, READY);
+        enqueue(system->ready_queue, proc);
 
-        if (proc->blocked_until <= system->current_time) {
-            proc->state = READY;
-            if (removeNodeByData(system->blocked_queue, proc)) {
-                enqueue(system->ready_queue, proc);
-                i--;
-                size--;
-            }
+        PCB* next = (PCB*)io_next_waiting(&system->io, device);
+        if (next) {
+            next->blocked_until = system->current_time + next->io_service;
+            io_schedule(&system->io, device, next, next->blocked_until);
         }
     }
 }
@@ -97,7 +216,7 @@ void update_new_processes(SimulationSystem* system) {
 
         proc->time_in_state++;
         if (proc->time_in_state > 2) {
-            proc->state = READY;
+            set_process_state(system, proc, READY);
             if (removeNodeByData(system->new_queue, proc)) {
                 enqueue(system->ready_queue, proc);
                 i--;
@@ -105,6 +224,73 @@ void update_new_processes(SimulationSystem* system) {
             }
         }
     }
+
+    // Processos injetados/chegados entram agora, tal como os criados por EXEC
+    drain_injected_processes(system);
+    admit_arrivals(system);
+}
+
+/* External process injection */
+/**
+ * Queues a new process of program_id for the running simulation.
+ * Safe to call from any thread; never blocks. Returns 1 if queued.
+ */
+int submit_process(SimulationSystem* system, int program_id) {
+    if (!system || !system->injection_queue) return 0;
+
+    SpawnRequest* request = (SpawnRequest*)malloc(sizeof(SpawnRequest));
+    if (!request) return 0;
+
+    request->program_id = program_id;
+    mpscPush(system->injection_queue, &request->node);
+    return 1;
+}
+
+/**
+ * Moves every submitted request into new_queue (simulation thread only).
+ */
+void drain_injected_processes(SimulationSystem* system) {
+    if (!system->injection_queue) return;
+
+    MpscNode* node;
+    while ((node = mpscPop(system->injection_queue)) != NULL) {
+        SpawnRequest* request = (SpawnRequest*)node;
+        if (system->replay_log) {
+            replay_record_spawn(system->replay_log, system->current_time, request->program_id);
+        }
+        PCB* new_proc = create_new_process(system, request->program_id);
+
+        if (new_proc) {
+            enqueue(system->new_queue, new_proc);
+        } else {
+            system->rejected_injections++;
+        }
+        free(request);
+    }
+}
+
+/**
+ * Admits every arrival from the trace that is due at the current time.
+ */
+void admit_arrivals(SimulationSystem* system) {
+    if (!system->arrivals) return;
+
+    Arrival arrival;
+    while (arrivals_pop_due(system->arrivals, system->current_time, &arrival)) {
+        if (system->replay_log) {
+            replay_record_spawn(system->replay_log, system->current_time, arrival.program_id);
+        }
+        PCB* new_proc = create_new_process(system, arrival.program_id);
+
+        if (new_proc) {
+            enqueue(system->new_queue, new_proc);
+            system->arrivals->admitted++;
+        } else if (system->arrivals->rejected++ == 0) {
+            fprintf(stderr, "arrivals: rejecting program %d at tick %d (%s)\n",
+                    arrival.program_id, system->current_time,
+                    system->next_pid > MAX_PROCESSES ? "all PIDs used; PIDs are not reused" : "invalid program");
+        }
+    }
 }
 
 void update_exit_processes(SimulationSystem* system) {
@@ -118,13 +304,8 @@ void update_exit_processes(SimulationSystem* system) {
         proc->time_in_state++;
         if (proc->time_in_state >= 1) {
             if (removeNodeByData(system->exit_queue, proc)) {
-                if (proc->instructions) {
-                    free(proc->instructions);
-                }
-                if (proc->pid > 0 && proc->pid <= 20) {
-                    system->processes[proc->pid - 1] = NULL;
-                }
-                free(proc);
+                SIM_TRACE(exit_reap, system->current_time, proc->pid, proc->program_id, 0);
+                release_process(system, proc);
                 i--;
                 size--;
             }
@@ -135,12 +316,12 @@ void update_exit_processes(SimulationSystem* system) {
 /* Instruction EXEC */
 void execute_instruction(SimulationSystem* system, PCB* proc, int instruction) {
     if (proc == NULL || proc->instructions == NULL) {
-        if (proc) proc->state = EXIT;
+        if (proc) set_process_state(system, proc, EXIT);
         return;
     }
 
     if (instruction == 0 || proc->pc < 0 || proc->pc >= proc->instruction_count) {
-        proc->state = EXIT;
+        set_process_state(system, proc, EXIT);
         return;
     }
 
@@ -150,19 +331,23 @@ void execute_instruction(SimulationSystem* system, PCB* proc, int instruction) {
     }
     else if (instruction >= 201 && instruction <= 299) { // EXEC
         int program_id = instruction % 100;
-        if (system->next_pid <= 20 && program_id >= 0 && program_id < 5) {
+        if (system->next_pid <= MAX_PROCESSES && program_id >= 0 && program_id < 5) {
             PCB* new_proc = create_new_process(system, program_id);
             if (new_proc) {
-                new_proc->state = NEW;
-                new_proc->time_in_state = 0;
                 enqueue(system->new_queue, new_proc);
             }
         }
     }
     else if (instruction < 0) { // I/O
-        proc->state = BLOCKED;
-        proc->blocked_until = system->current_time + (-instruction);
-        enqueue(system->blocked_queue, proc);
+        set_process_state(system, proc, BLOCKED);
+        io_decode(&system->io, instruction, &proc->io_device, &proc->io_service);
+        if (io_acquire(&system->io, proc->io_device)) {
+            proc->blocked_until = system->current_time + proc->io_service;
+            io_schedule(&system->io, proc->io_device, proc, proc->blocked_until);
+        } else {
+            proc->blocked_until = -1;  // À espera de canal livre
+            io_wait(&system->io, proc->io_device, proc);
+        }
         system->running_process = NULL;
         return;
     }
@@ -172,12 +357,30 @@ void execute_instruction(SimulationSystem* system, PCB* proc, int instruction) {
     }
 }
 
+/**
+ * Takes a zeroed PCB from the pool, with room for MAX_INSTRUCTIONS
+ * instructions already attached. Not yet in the process table.
+ */
+PCB* allocate_process(SimulationSystem* system) {
+    ProcessImage* image = (ProcessImage*)arena_pool_alloc(&system->process_pool);
+    if (!image) return NULL;
+
+    memset(image, 0, sizeof(ProcessImage));
+    image->pcb.instructions = image->code;
+    return &image->pcb;
+}
+
 PCB* create_new_process(SimulationSystem* system, int prog_id) {
-    if (!system || prog_id < 0 || prog_id >= 5 || system->next_pid > 20) {
+    if (!system || prog_id < 0 || prog_id >= 5 || system->next_pid > MAX_PROCESSES) {
+        return NULL;
+    }
+
+    PCB* new_process = allocate_process(system);
+    if (!new_process) {
+        fprintf(stderr, "Memory allocation failed for process\n");
         return NULL;
     }
 
-    PCB* new_process = (PCB*)calloc(1, sizeof(PCB));
     new_process->pid = system->next_pid++;
     new_process->program_id = prog_id;
     new_process->state = NEW;
@@ -188,23 +391,27 @@ PCB* create_new_process(SimulationSystem* system, int prog_id) {
 
     int length = system->program_lengths[prog_id];
     new_process->instruction_count = length;
-    new_process->instructions = (int*)malloc(length * sizeof(int));
-
-    if (!new_process->instructions) {
-        fprintf(stderr, "Memory allocation failed for process instructions\n");
-        free(new_process);
-        return NULL;
-    }
 
     for (int i = 0; i < length; i++) {
         new_process->instructions[i] = system->programs[prog_id][i];
     }
 
-    system->processes[new_process->pid - 1] = new_process;
+    track_process(system, new_process);
 
     return new_process;
 }
 
+/**
+ * Removes a reaped process from the table and recycles its memory.
+ */
+void release_process(SimulationSystem* system, PCB* process) {
+    untrack_process(system, process);
+    if (process->pid > 0 && process->pid <= MAX_PROCESSES) {
+        system->processes[process->pid - 1] = NULL;
+    }
+    arena_pool_free(&system->process_pool, process);
+}
+
 /* Process EXEC */
 void execute_running_process(SimulationSystem* system) {
     if (!system || !system->running_process) return;
@@ -213,7 +420,7 @@ void execute_running_process(SimulationSystem* system) {
 
     if (proc->pc >= proc->instruction_count ||
         (proc->pc < proc->instruction_count && proc->instructions[proc->pc] == 0)) {
-        proc->state = EXIT;
+        set_process_state(system, proc, EXIT);
         proc->time_in_state = 0;
         enqueue(system->exit_queue, proc);
         system->running_process = NULL;
@@ -226,7 +433,8 @@ void execute_running_process(SimulationSystem* system) {
     if (proc->state == RUNNING) {
         proc->remaining_quantum--;
         if (proc->remaining_quantum == 0) {
-            proc->state = READY;
+            SIM_TRACE(quantum_expire, system->current_time, proc->pid, proc->pc, 0);
+            set_process_state(system, proc, READY);
             enqueue(system->ready_queue, proc);
             system->running_process = NULL;
         }
@@ -237,99 +445,147 @@ void execute_running_process(SimulationSystem* system) {
 void schedule_next_process(SimulationSystem* system) {
     if (!system || system->running_process) return;
 
-    if (!isEmpty(system->ready_queue)) {
+    if (system->state_counts[READY] > 0) {
         PCB* next = dequeue(system->ready_queue);
         if (next) {
-            next->state = RUNNING;
-            next->remaining_quantum = 3;
+            SIM_TRACE(schedule, system->current_time, next->pid, system->state_counts[READY], 0);
+            set_process_state(system, next, RUNNING);
+            next->remaining_quantum = QUANTUM;
             system->running_process = next;
         }
     }
 }
 
 /* Outputs */
+static void print_header(FILE* out) {
+    fputs("time inst", out);
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        fprintf(out, "\tproc%d%s", i + 1, i + 1 < MAX_PROCESSES ? "\t" : "");
+    }
+    fputc('\n', out);
+}
+
+/**
+ * Prints one row of the state table. The row is cached between ticks and
+ * only the cells of slots in dirty_set are re-rendered.
+ */
 void print_current_state(SimulationSystem* system, int time) {
     if (!system) return;
 
+    FILE* out = system->output ? system->output : stdout;
     if (time == 1) {
-        printf("time inst\tproc1\t\tproc2\t\tproc3\t\tproc4\t\tproc5\t\tproc6\t\tproc7\t\tproc8\t\tproc9\t\tproc10\t\tproc11\t\tproc12\t\tproc13\t\tproc14\t\tproc15\t\tproc16\t\tproc17\t\tproc18\t\tproc19\t\tproc20\n");
+        print_header(out);
     }
 
-    printf("%-8d", time);
-
-    for (int i = 0; i < 20; i++) {
+    for (int slot = procset_next(&system->dirty_set, 0); slot >= 0;
+         slot = procset_next(&system->dirty_set, slot + 1)) {
+        PCB* proc = system->processes[slot];
         const char* state = "";
 
-        if (system->processes[i]) {
-            switch (system->processes[i]->state) {
-                case NEW:     state = "NEW";     break;
-                case READY:   state = "READY";   break;
-                case RUNNING: state = "RUN";     break;
-                case BLOCKED: state = "BLOCKED"; break;
-                case EXIT:    state = "EXIT";    break;
-                default:      state = "?";       break;
-            }
-        } else {
-            state = "";
+        if (proc && procset_contains(&system->live_set, slot)) {
+            state = state_name(proc->state);
         }
-
-        printf("\t%-8s", state);
+        render_cell(system->row_cells + slot * CELL_WIDTH, state);
     }
-    printf("\n");
+    procset_clear(&system->dirty_set);
+
+    print_state_row(out, time, system->row_cells);
 }
 
-/* main flow */
-void run_simulation(SimulationSystem* system) {
-    for (int time = 1; time <= 100; time++) {
-        system->current_time = time;
+void print_state_row(FILE* out, int time, const char* cells) {
+    fprintf(out, "%-8d", time);
+    fwrite(cells, 1, MAX_PROCESSES * CELL_WIDTH, out);
+    fputc('\n', out);
+}
 
-        // Debug: Print current time
+/* main flow */
+/**
+ * Advances the simulation by one tick.
+ * Returns 1 while there are live processes (or pending arrivals), 0 once
+ * the system is empty.
+ */
+int simulation_step(SimulationSystem* system) {
+    // Com o profiler: relógio lido entre as fases (0 = tick não amostrado)
+    PhaseProfiler* profiler = system->profiler;
+    uint64_t mark = profiler ? phase_profiler_begin(profiler) : 0;
+    system->current_time++;
+
+    // Update all process states
+    update_exit_processes(system);
+    if (mark) mark = phase_profiler_record(profiler, PHASE_EXIT, mark);
+    update_blocked_processes(system);
+    if (mark) mark = phase_profiler_record(profiler, PHASE_BLOCKED, mark);
+    update_new_processes(system);
+    if (mark) mark = phase_profiler_record(profiler, PHASE_NEW, mark);
+
+    // Execute the running process
+    if (system->running_process) {
+        execute_running_process(system);
+    }
+    if (mark) mark = phase_profiler_record(profiler, PHASE_EXECUTE, mark);
 
-        // Update all process states
-        update_exit_processes(system);
-        update_blocked_processes(system);
-        update_new_processes(system);
+    // Schedule the next process
+    if (!system->running_process) {
+        schedule_next_process(system);
+    }
+    if (mark) mark = phase_profiler_record(profiler, PHASE_SCHEDULE, mark);
 
-        // Execute the running process
-        if (system->running_process) {
-            execute_running_process(system);
-        }
+    // Emit system state
+    metrics_tick(system);
+    if (mark) mark = phase_profiler_record(profiler, PHASE_METRICS, mark);
+    sinks_tick(system);
+    if (mark) phase_profiler_record(profiler, PHASE_OUTPUT, mark);
 
-        // Schedule the next process
-        if (!system->running_process) {
-            schedule_next_process(system);
-        }
-
-        // Print system state
-        print_current_state(system, time);
+    return has_live_processes(system) || arrivals_next_time(system->arrivals) >= 0;
+}
 
+void run_simulation(SimulationSystem* system) {
+    // Reserva antes do ciclo tudo o que os programas carregados podem criar
+    WorkloadAnalysis analysis;
+    analyze_workload(system, &analysis);
+    presize_system(system, &analysis, system->arrivals != NULL);
+
+    // Um checkpoint do último tick já não tem nada para simular
+    int live = has_live_processes(system) || arrivals_next_time(system->arrivals) >= 0;
+    while (live && system->current_time < system->max_ticks) {
         // Check for termination
-        if (isEmpty(system->new_queue) &&
-            isEmpty(system->ready_queue) &&
-            isEmpty(system->blocked_queue) &&
-            isEmpty(system->exit_queue) &&
-            !system->running_process) {
+        if (!simulation_step(system)) {
             break;
         }
+        CycleDetector* detector = system->cycle_detector;
+        if (detector) {
+            cycle_detector_tick(detector, system);
+        }
+        // Não interrompe a medição de um período
+        if (system->skip_ahead && (!detector || detector->period == 0) &&
+            simulation_skip_ahead(system) > 0 && detector) {
+            cycle_detector_reset(detector);
+        }
     }
+
+    sinks_finish(system);
 }
 
 /* Cleanup */
 void cleanup_simulation(SimulationSystem* system) {
     if (!system) return;
 
-    for (int i = 0; i < 20; i++) {
-        if (system->processes[i]) {
-            if (system->processes[i]->instructions) {
-                free(system->processes[i]->instructions);
-            }
-            free(system->processes[i]);
-            system->processes[i] = NULL;
+    // PCBs, filas e nós vivem todos na arena da execução
+    arena_release(&system->arena);
+    for (int i = 0; i < MAX_PROCESSES; i++) {
+        system->processes[i] = NULL;
+    }
+    system->running_process = NULL;
+    system->new_queue = NULL;
+    system->ready_queue = NULL;
+    system->exit_queue = NULL;
+    memset(&system->io, 0, sizeof(IoSubsystem));
+
+    if (system->injection_queue) {
+        MpscNode* node;
+        while ((node = mpscPop(system->injection_queue)) != NULL) {
+            free(node);
         }
+        deleteMpscQueue(system->injection_queue);
     }
-
-    if (system->new_queue) deleteQueue(system->new_queue);
-    if (system->ready_queue) deleteQueue(system->ready_queue);
-    if (system->blocked_queue) deleteQueue(system->blocked_queue);
-    if (system->exit_queue) deleteQueue(system->exit_queue);
 }
\ No newline at end of file
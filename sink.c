@@ -0,0 +1,69 @@
+#include "include/sink.h"
+
+/* Default sink */
+static void table_output_tick(OutputSink* sink, SimulationSystem* system) {
+    (void)sink;
+    print_current_state(system, system->current_time);
+}
+
+OutputSink table_output_sink = {NULL, table_output_tick, NULL, NULL};
+
+/* Registration */
+/**
+ * Adds a sink to the system. Processes that already exist are announced to
+ * the new sink as transitions from NO_STATE, so a sink attached after
+ * initialize_system_with_input() still sees them being created.
+ * Returns 1 on success, 0 if the table is full.
+ */
+int simulation_add_sink(SimulationSystem* system, OutputSink* sink) {
+    if (!system || !sink || system->sink_count >= MAX_SINKS) {
+        return 0;
+    }
+    system->sinks[system->sink_count++] = sink;
+
+    if (sink->on_transition) {
+        for (int slot = procset_next(&system->live_set, 0); slot >= 0;
+             slot = procset_next(&system->live_set, slot + 1)) {
+            PCB* proc = system->processes[slot];
+            sink->on_transition(sink, system, proc, NO_STATE, proc->state);
+        }
+    }
+    return 1;
+}
+
+void simulation_clear_sinks(SimulationSystem* system) {
+    if (!system) return;
+
+    for (int i = 0; i < system->sink_count; i++) {
+        system->sinks[i] = NULL;
+    }
+    system->sink_count = 0;
+}
+
+/* Dispatch */
+void sinks_transition(SimulationSystem* system, const PCB* process, int from, int to) {
+    for (int i = 0; i < system->sink_count; i++) {
+        OutputSink* sink = system->sinks[i];
+        if (sink->on_transition) {
+            sink->on_transition(sink, system, process, from, to);
+        }
+    }
+}
+
+void sinks_tick(SimulationSystem* system) {
+    for (int i = 0; i < system->sink_count; i++) {
+        OutputSink* sink = system->sinks[i];
+        if (sink->on_tick) {
+            sink->on_tick(sink, system);
+        }
+    }
+}
+
+void sinks_finish(SimulationSystem* system) {
+    for (int i = 0; i < system->sink_count; i++) {
+        OutputSink* sink = system->sinks[i];
+        if (sink->on_finish) {
+            sink->on_finish(sink, system);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include "include/sosim.h"
+
+typedef struct {
+    OutputSink sink;
+    SimTransitionObserver observer;
+    void* ctx;
+} Observer;
+
+/* Observers */
+static void observer_transition(OutputSink* sink, const SimulationSystem* system, const PCB* process, int from, int to) {
+    Observer* observer = (Observer*)sink->ctx;
+    observer->observer(observer->ctx, system, process, from, to);
+}
+
+OutputSink* sosim_add_observer(SimulationSystem* system, SimTransitionObserver observer, void* ctx) {
+    if (!system || !observer) return NULL;
+
+    Observer* entry = (Observer*)calloc(1, sizeof(Observer));
+    if (!entry) return NULL;
+
+    entry->sink.on_transition = observer_transition;
+    entry->sink.ctx = entry;
+    entry->observer = observer;
+    entry->ctx = ctx;
+    if (!simulation_add_sink(system, &entry->sink)) {
+        free(entry);
+        return NULL;
+    }
+    return &entry->sink;
+}
+
+/* Lifecycle */
+SimulationSystem* sosim_create(SimulationInput input) {
+    SimulationSystem* system = (SimulationSystem*)malloc(sizeof(SimulationSystem));
+    if (!system) return NULL;
+
+    initialize_system_with_input(system, input);
+    // Sem tabela: quem usa a biblioteca lê o estado diretamente
+    simulation_clear_sinks(system);
+    return system;
+}
+
+void sosim_destroy(SimulationSystem* system) {
+    if (!system) return;
+
+    for (int i = 0; i < system->sink_count; i++) {
+        if (system->sinks[i]->on_transition == observer_transition) {
+            free(system->sinks[i]->ctx);
+        }
+    }
+    cleanup_simulation(system);
+    free(system);
+}
+
+/* Stepping */
+int sosim_step(SimulationSystem* system) {
+    if (system->current_time >= system->max_ticks) return 0;
+    return simulation_step(system);
+}
+
+int sosim_run_until(SimulationSystem* system, int time) {
+    while (system->current_time < time) {
+        if (!sosim_step(system)) return 0;
+    }
+    return system->current_time < system->max_ticks;
+}
+
+void sosim_run(SimulationSystem* system) {
+    run_simulation(system);
+}
@@ -0,0 +1,367 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "include/span_index.h"
+
+#define TRAILER_SIZE (8 + 3 * 4)
+
+typedef struct {
+    long offset;
+    int first_start;
+    int count;
+} SpanBlock;
+
+typedef struct {
+    SpanBlock* blocks;
+    int block_count;
+    int block_capacity;
+    StateSpan pending[SPAN_INDEX_BLOCK];   // Intervalos ainda não escritos
+    int pending_count;
+    int open_state;         // Estado atual (NO_STATE = não existe)
+    int open_start;
+} PidSpans;
+
+typedef struct {
+    FILE* file;
+    PidSpans pids[MAX_PROCESSES];
+    int end_time;
+    int failed;
+    int finished;
+} SpanWriter;
+
+struct SpanIndex {
+    FILE* file;
+    int end_time;
+    int pid_count;
+    SpanBlock** blocks;     // Diretório: blocos de cada PID
+    int* block_counts;
+    StateSpan cache[SPAN_INDEX_BLOCK];     // Último bloco lido
+    int cache_pid;
+    int cache_block;
+    int cache_count;
+};
+
+/* Encoding */
+static void write_int(SpanWriter* writer, int value) {
+    int32_t v = (int32_t)value;
+    if (fwrite(&v, sizeof(v), 1, writer->file) != 1) writer->failed = 1;
+}
+
+static void write_long(SpanWriter* writer, long value) {
+    int64_t v = (int64_t)value;
+    if (fwrite(&v, sizeof(v), 1, writer->file) != 1) writer->failed = 1;
+}
+
+static int read_int(FILE* file, int* value) {
+    int32_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (int)v;
+    return 1;
+}
+
+static int read_long(FILE* file, long* value) {
+    int64_t v;
+    if (fread(&v, sizeof(v), 1, file) != 1) return 0;
+    *value = (long)v;
+    return 1;
+}
+
+/* Writing */
+static void flush_block(SpanWriter* writer, PidSpans* spans) {
+    if (spans->pending_count == 0) return;
+
+    if (spans->block_count == spans->block_capacity) {
+        int capacity = spans->block_capacity ? spans->block_capacity * 2 : 16;
+        SpanBlock* blocks = (SpanBlock*)realloc(spans->blocks, capacity * sizeof(SpanBlock));
+        if (!blocks) {
+            writer->failed = 1;
+            spans->pending_count = 0;
+            return;
+        }
+        spans->blocks = blocks;
+        spans->block_capacity = capacity;
+    }
+
+    SpanBlock* block = &spans->blocks[spans->block_count++];
+    block->offset = ftell(writer->file);
+    block->first_start = spans->pending[0].start;
+    block->count = spans->pending_count;
+    for (int i = 0; i < spans->pending_count; i++) {
+        write_int(writer, spans->pending[i].start);
+        write_int(writer, spans->pending[i].end);
+        write_int(writer, spans->pending[i].state);
+    }
+    spans->pending_count = 0;
+}
+
+static void close_span(SpanWriter* writer, PidSpans* spans, int end) {
+    if (spans->open_state == NO_STATE || end <= spans->open_start) return;
+
+    // Um estado de 0 ticks no meio (READY entre dois quanta) não separa os intervalos
+    if (spans->pending_count > 0) {
+        StateSpan* last = &spans->pending[spans->pending_count - 1];
+        if (last->state == spans->open_state && last->end == spans->open_start) {
+            last->end = end;
+            return;
+        }
+    }
+    if (spans->pending_count == SPAN_INDEX_BLOCK) {
+        flush_block(writer, spans);
+    }
+
+    StateSpan* span = &spans->pending[spans->pending_count++];
+    span->start = spans->open_start;
+    span->end = end;
+    span->state = spans->open_state;
+}
+
+static void span_index_transition(OutputSink* sink, const SimulationSystem* system,
+                                  const PCB* process, int from, int to) {
+    SpanWriter* writer = (SpanWriter*)sink->ctx;
+    int slot = process->pid - 1;
+    (void)from;
+    if (writer->finished || slot < 0 || slot >= MAX_PROCESSES) return;
+
+    PidSpans* spans = &writer->pids[slot];
+    close_span(writer, spans, system->current_time);
+    spans->open_state = to;
+    spans->open_start = system->current_time;
+}
+
+static void span_index_finish(OutputSink* sink, SimulationSystem* system) {
+    SpanWriter* writer = (SpanWriter*)sink->ctx;
+    if (writer->finished) return;
+
+    // A linha do instante t cobre [t, t+1)
+    writer->end_time = system->current_time + 1;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        close_span(writer, &writer->pids[slot], writer->end_time);
+        writer->pids[slot].open_state = NO_STATE;
+        flush_block(writer, &writer->pids[slot]);
+    }
+
+    long directory = ftell(writer->file);
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        PidSpans* spans = &writer->pids[slot];
+        write_int(writer, spans->block_count);
+        for (int b = 0; b < spans->block_count; b++) {
+            write_long(writer, spans->blocks[b].offset);
+            write_int(writer, spans->blocks[b].first_start);
+            write_int(writer, spans->blocks[b].count);
+        }
+    }
+    write_long(writer, directory);
+    write_int(writer, writer->end_time);
+    write_int(writer, MAX_PROCESSES);
+    write_int(writer, (int)SPAN_INDEX_MAGIC);
+    if (fflush(writer->file) != 0) writer->failed = 1;
+    writer->finished = 1;
+}
+
+/* Lifecycle */
+OutputSink* span_index_open(const char* path) {
+    OutputSink* sink = (OutputSink*)calloc(1, sizeof(OutputSink));
+    SpanWriter* writer = (SpanWriter*)calloc(1, sizeof(SpanWriter));
+    if (!sink || !writer) {
+        free(sink);
+        free(writer);
+        return NULL;
+    }
+
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        free(sink);
+        free(writer);
+        return NULL;
+    }
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        writer->pids[slot].open_state = NO_STATE;
+    }
+    write_int(writer, (int)SPAN_INDEX_MAGIC);
+    write_int(writer, SPAN_INDEX_VERSION);
+
+    sink->on_transition = span_index_transition;
+    sink->on_finish = span_index_finish;
+    sink->ctx = writer;
+    return sink;
+}
+
+int span_index_close(OutputSink* sink) {
+    if (!sink) return 1;
+
+    SpanWriter* writer = (SpanWriter*)sink->ctx;
+    int ok = writer->finished && !writer->failed;
+    if (fclose(writer->file) != 0) ok = 0;
+    for (int slot = 0; slot < MAX_PROCESSES; slot++) {
+        free(writer->pids[slot].blocks);
+    }
+    free(writer);
+    free(sink);
+    return ok;
+}
+
+/* Loading */
+SpanIndex* span_index_load(const char* path) {
+    SpanIndex* index = (SpanIndex*)calloc(1, sizeof(SpanIndex));
+    if (!index) return NULL;
+    index->cache_pid = -1;
+
+    index->file = fopen(path, "rb");
+    if (!index->file) {
+        free(index);
+        return NULL;
+    }
+
+    int magic = 0, version = 0;
+    long directory = 0;
+    int ok = read_int(index->file, &magic) && read_int(index->file, &version) &&
+             (uint32_t)magic == SPAN_INDEX_MAGIC && version == SPAN_INDEX_VERSION &&
+             fseek(index->file, -TRAILER_SIZE, SEEK_END) == 0 &&
+             read_long(index->file, &directory) && read_int(index->file, &index->end_time) &&
+             read_int(index->file, &index->pid_count) && read_int(index->file, &magic) &&
+             (uint32_t)magic == SPAN_INDEX_MAGIC && index->pid_count > 0 &&
+             fseek(index->file, directory, SEEK_SET) == 0;
+
+    if (ok) {
+        index->blocks = (SpanBlock**)calloc(index->pid_count, sizeof(SpanBlock*));
+        index->block_counts = (int*)calloc(index->pid_count, sizeof(int));
+        ok = index->blocks && index->block_counts;
+    }
+    for (int p = 0; ok && p < index->pid_count; p++) {
+        int count = 0;
+        ok = read_int(index->file, &count) && count >= 0;
+        if (!ok || count == 0) continue;
+
+        index->blocks[p] = (SpanBlock*)malloc(count * sizeof(SpanBlock));
+        index->block_counts[p] = count;
+        ok = index->blocks[p] != NULL;
+        for (int b = 0; ok && b < count; b++) {
+            SpanBlock* block = &index->blocks[p][b];
+            ok = read_long(index->file, &block->offset) && read_int(index->file, &block->first_start) &&
+                 read_int(index->file, &block->count) && block->count > 0 && block->count <= SPAN_INDEX_BLOCK;
+        }
+    }
+
+    if (!ok) {
+        span_index_free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void span_index_free(SpanIndex* index) {
+    if (!index) return;
+
+    if (index->blocks) {
+        for (int p = 0; p < index->pid_count; p++) free(index->blocks[p]);
+    }
+    free(index->blocks);
+    free(index->block_counts);
+    fclose(index->file);
+    free(index);
+}
+
+int span_index_end_time(const SpanIndex* index) {
+    return index->end_time;
+}
+
+int span_index_pid_count(const SpanIndex* index) {
+    return index->pid_count;
+}
+
+/* Queries */
+static int load_block(SpanIndex* index, int slot, int b) {
+    if (index->cache_pid == slot && index->cache_block == b) return 1;
+
+    const SpanBlock* block = &index->blocks[slot][b];
+    index->cache_pid = -1;
+    if (fseek(index->file, block->offset, SEEK_SET) != 0) return 0;
+    for (int i = 0; i < block->count; i++) {
+        StateSpan* span = &index->cache[i];
+        if (!read_int(index->file, &span->start) || !read_int(index->file, &span->end) ||
+            !read_int(index->file, &span->state)) {
+            return 0;
+        }
+    }
+    index->cache_pid = slot;
+    index->cache_block = b;
+    index->cache_count = block->count;
+    return 1;
+}
+
+/**
+ * Finds the last span of slot starting at or before time: its block in
+ * *block and its position in the cached block (which it loads).
+ * Returns 0 if every span starts after time (block 0 is then loaded) and
+ * -1 if the block could not be read.
+ */
+static int find_span(SpanIndex* index, int slot, int time, int* block, int* position) {
+    int low = 0, high = index->block_counts[slot] - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (index->blocks[slot][middle].first_start <= time) low = middle;
+        else high = middle - 1;
+    }
+    *block = low;
+    *position = 0;
+    if (!load_block(index, slot, low)) return -1;
+
+    int first = 0, last = index->cache_count - 1;
+    if (index->cache[0].start > time) return 0;
+    while (first < last) {
+        int middle = (first + last + 1) / 2;
+        if (index->cache[middle].start <= time) first = middle;
+        else last = middle - 1;
+    }
+    *position = first;
+    return 1;
+}
+
+int span_index_state_at(SpanIndex* index, int pid, int time) {
+    int slot = pid - 1;
+    int block, position;
+    if (slot < 0 || slot >= index->pid_count || index->block_counts[slot] == 0) return NO_STATE;
+
+    if (find_span(index, slot, time, &block, &position) <= 0) return NO_STATE;
+    const StateSpan* span = &index->cache[position];
+    return time < span->end ? span->state : NO_STATE;
+}
+
+int span_index_spans(SpanIndex* index, int pid, int from, int to, StateSpan* spans, int max) {
+    int slot = pid - 1;
+    int block, position;
+    int found = 0;
+    if (slot < 0 || slot >= index->pid_count || index->block_counts[slot] == 0 || to < from) return 0;
+
+    int located = find_span(index, slot, from, &block, &position);
+    if (located < 0) return 0;
+    if (located && index->cache[position].end <= from) {
+        position++;     // Termina antes de from
+    }
+    while (block < index->block_counts[slot]) {
+        if (!load_block(index, slot, block)) break;
+        for (; position < index->cache_count; position++) {
+            const StateSpan* span = &index->cache[position];
+            if (span->start > to || found == max) return found;
+            spans[found++] = *span;
+        }
+        block++;
+        position = 0;
+    }
+    return found;
+}
+
+int span_index_was_in_state(SpanIndex* index, int pid, int state, int from, int to) {
+    StateSpan spans[SPAN_INDEX_BLOCK];
+    int offset = from;
+
+    // Por janelas de intervalos, sem carregar o histórico todo do PID
+    while (offset <= to) {
+        int found = span_index_spans(index, pid, offset, to, spans, SPAN_INDEX_BLOCK);
+        for (int i = 0; i < found; i++) {
+            if (spans[i].state == state) return 1;
+        }
+        if (found < SPAN_INDEX_BLOCK) return 0;
+        offset = spans[found - 1].end;
+    }
+    return 0;
+}
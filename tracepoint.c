@@ -0,0 +1,35 @@
+#include "include/tracepoint.h"
+
+#ifdef SIM_TRACEPOINTS
+
+TraceHandler trace_handlers[NUM_TRACEPOINTS];
+
+/**
+ * Registers the callback for a tracepoint (replaces any previous one).
+ */
+void tracepoint_register(int tracepoint, TraceCallback callback, void* ctx) {
+    if (tracepoint < 0 || tracepoint >= NUM_TRACEPOINTS) return;
+
+    trace_handlers[tracepoint].ctx = ctx;
+    trace_handlers[tracepoint].callback = callback;
+}
+
+void tracepoint_unregister(int tracepoint) {
+    if (tracepoint < 0 || tracepoint >= NUM_TRACEPOINTS) return;
+
+    trace_handlers[tracepoint].callback = 0;
+    trace_handlers[tracepoint].ctx = 0;
+}
+
+/**
+ * Slow path of SIM_TRACE(): only reached when a callback is registered.
+ */
+void tracepoint_fire(int tracepoint, int time, int pid, int arg0, int arg1) {
+    TraceHandler handler = trace_handlers[tracepoint];
+    if (!handler.callback) return;
+
+    TraceRecord record = {tracepoint, time, pid, arg0, arg1};
+    handler.callback(&record, handler.ctx);
+}
+
+#endif /* SIM_TRACEPOINTS */